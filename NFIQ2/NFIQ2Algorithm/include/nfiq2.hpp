@@ -16,6 +16,7 @@
 #include <nfiq2_data.hpp>
 #include <nfiq2_exception.hpp>
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <nfiq2_modelinfo.hpp>
 #include <nfiq2_qualitymeasures.hpp>
 #include <nfiq2_timer.hpp>
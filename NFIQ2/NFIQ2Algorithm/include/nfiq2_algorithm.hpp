@@ -12,13 +12,17 @@
 #define NFIQ2_ALGORITHM_HPP_
 
 #include <nfiq2_constants.hpp>
+#include <nfiq2_exception.hpp>
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <nfiq2_modelinfo.hpp>
 #include <nfiq2_qualitymeasures.hpp>
 
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #ifdef __ANDROID__
 #include <android/asset_manager.h>
@@ -26,22 +30,73 @@
 
 namespace NFIQ2 {
 
+/** Outcome of computing the unified quality score of one of many images. */
+struct UnifiedQualityScoreResult {
+	/** Whether the unified quality score could be computed. */
+	bool success { false };
+	/** Computed unified quality score, if `success`. */
+	unsigned int unifiedQualityScore {};
+	/** Code broadly describing why the score could not be computed. */
+	NFIQ2::ErrorCode errorCode { NFIQ2::ErrorCode::UnknownError };
+	/** Description of why the score could not be computed. */
+	std::string errorMessage {};
+};
+
+/** Outcome of deciding whether a unified quality score meets a threshold. */
+struct QualityThresholdResult {
+	/** Whether the unified quality score is at least the threshold. */
+	bool meetsThreshold { false };
+	/** Number of random forest trees evaluated to decide. */
+	unsigned int treesEvaluated {};
+	/** Number of random forest trees. */
+	unsigned int treeCount {};
+};
+
 /**
  * Applies trained random forest parameters to native quality measures,
  * computing a unified quality score.
+ *
+ * @details
+ * Random forest parameters are loaded once per process: instances and
+ * copies using the same file and checksum (or the same compiled-in
+ * parameters) share a single read-only model.
  */
 class Algorithm {
     public:
+	/** When random forest parameters are loaded. */
+	enum class ModelLoading {
+		/** While constructing, which blocks until they are loaded. */
+		Immediate,
+		/**
+		 * On a background thread started while constructing.
+		 * Native quality measures are computed while loading, and
+		 * only the random forest evaluation waits for it to
+		 * complete. Loading errors are thrown by the first method
+		 * needing the parameters.
+		 */
+		Background
+	};
+
 	/**
 	 * @brief
 	 * Default constructor of Algorithm.
 	 *
 	 * @note
 	 * May load from parameters compiled into source code, in which case
-	 * this can be slow.
+	 * the first instance can be slow.
 	 */
 	Algorithm();
 
+	/**
+	 * @brief
+	 * Constructor choosing when to load parameters compiled into source
+	 * code, if any.
+	 *
+	 * @param loading
+	 * When to load the random forest parameters.
+	 */
+	explicit Algorithm(const ModelLoading loading);
+
 	/**
 	 * @brief
 	 * Constructor that loads random forest parameters from disk.
@@ -50,8 +105,32 @@ class Algorithm {
 	 * The file path containing the random forest model.
 	 * @param fileHash
 	 * The md5 checksum of the provided file.
+	 *
+	 * @note
+	 * If parameters from the same file and checksum are already in
+	 * use, they are shared and the file is not read again.
 	 */
 	Algorithm(const std::string &fileName, const std::string &fileHash);
+
+	/**
+	 * @brief
+	 * Constructor that loads random forest parameters from disk, possibly
+	 * in the background.
+	 *
+	 * @param fileName
+	 * The file path containing the random forest model.
+	 * @param fileHash
+	 * The md5 checksum of the provided file.
+	 * @param loading
+	 * When to load the random forest parameters.
+	 *
+	 * @note
+	 * With ModelLoading::Background, a missing file or wrong checksum is
+	 * reported by the first method needing the parameters rather than by
+	 * this constructor.
+	 */
+	Algorithm(const std::string &fileName, const std::string &fileHash,
+	    const ModelLoading loading);
 #ifdef __ANDROID__
 	Algorithm(AAssetManager *assets, const std::string &fileName,
 	    const std::string &fileHash);
@@ -66,7 +145,20 @@ class Algorithm {
 	 */
 	Algorithm(const NFIQ2::ModelInfo &modelInfoObj);
 
-	/** Copy constructor. */
+	/**
+	 * @brief
+	 * Constructor using NFIQ2::ModelInfo to initialize the random forest,
+	 * possibly in the background.
+	 *
+	 * @param modelInfoObj
+	 * Contains the random forest model and information about it.
+	 * @param loading
+	 * When to load the random forest parameters.
+	 */
+	Algorithm(const NFIQ2::ModelInfo &modelInfoObj,
+	    const ModelLoading loading);
+
+	/** Copy constructor, sharing random forest parameters. */
 	Algorithm(const Algorithm &);
 
 	/** Assignment operator. */
@@ -97,7 +189,28 @@ class Algorithm {
 	 * @ingroup compute
 	 */
 	unsigned int computeUnifiedQualityScore(
-	    const NFIQ2::FingerprintImageData &rawImage) const;
+	    const NFIQ2::FingerprintImageView &rawImage) const;
+
+	/**
+	 * @brief
+	 * Compute a unified quality score.
+	 *
+	 * @param rawImage
+	 * Fingerprint image.
+	 * @param options
+	 * Options controlling the computation of native quality measures.
+	 *
+	 * @return
+	 * Computed unified quality score.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded.
+	 *
+	 * @ingroup compute
+	 */
+	unsigned int computeUnifiedQualityScore(
+	    const NFIQ2::FingerprintImageView &rawImage,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
 
 	/**
 	 * @brief
@@ -139,6 +252,307 @@ class Algorithm {
 	unsigned int computeUnifiedQualityScore(
 	    const std::unordered_map<std::string, double> &features) const;
 
+	/**
+	 * @brief
+	 * Decide whether the unified quality score is at least a threshold.
+	 *
+	 * @details
+	 * The unified quality score scales the number of random forest trees
+	 * voting for good quality. Trees are evaluated one at a time, and
+	 * evaluation stops as soon as the remaining trees can no longer
+	 * change the decision. The decision is always the same as comparing
+	 * computeUnifiedQualityScore(const std::unordered_map<std::string,
+	 * double> &) const to `threshold`.
+	 *
+	 * @param features
+	 * Map of quality measure algorithm identifiers to native quality
+	 * measures.
+	 * @param threshold
+	 * Lowest accepted unified quality score.
+	 *
+	 * @return
+	 * Decision, and the number of trees evaluated to reach it.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or a native
+	 * quality measure is missing.
+	 *
+	 * @ingroup compute
+	 */
+	QualityThresholdResult meetsQualityThreshold(
+	    const std::unordered_map<std::string, double> &features,
+	    const unsigned int threshold) const;
+
+	/**
+	 * @brief
+	 * Decide whether the unified quality score of an image is at least
+	 * a threshold.
+	 *
+	 * @param rawImage
+	 * Fingerprint image.
+	 * @param threshold
+	 * Lowest accepted unified quality score.
+	 *
+	 * @return
+	 * Decision, and the number of trees evaluated to reach it.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or native
+	 * quality measures could not be computed.
+	 *
+	 * @ingroup compute
+	 * @see meetsQualityThreshold(const std::unordered_map<std::string,
+	 * double> &, const unsigned int) const
+	 */
+	QualityThresholdResult meetsQualityThreshold(
+	    const NFIQ2::FingerprintImageView &rawImage,
+	    const unsigned int threshold) const;
+
+	/**
+	 * @brief
+	 * Compute unified quality scores of many images.
+	 *
+	 * @details
+	 * Images are distributed over up to `threadCount` threads, including
+	 * the calling thread, each computing one image at a time. A failure
+	 * to compute one image does not affect the others.
+	 *
+	 * @param rawImages
+	 * Fingerprint images.
+	 * @param threadCount
+	 * Maximum number of images computed concurrently. 0 uses one thread
+	 * per hardware thread.
+	 *
+	 * @return
+	 * Outcome for each image, in the order of `rawImages`.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or loading
+	 * them in the background failed (thrown once all images were
+	 * processed, instead of reporting the error for each image).
+	 *
+	 * @ingroup compute
+	 */
+	std::vector<UnifiedQualityScoreResult> computeUnifiedQualityScores(
+	    const std::vector<NFIQ2::FingerprintImageData> &rawImages,
+	    const unsigned int threadCount) const;
+
+	/**
+	 * @brief
+	 * Compute unified quality scores of many images.
+	 *
+	 * @param rawImages
+	 * Fingerprint images.
+	 * @param threadCount
+	 * Maximum number of images computed concurrently. 0 uses one thread
+	 * per hardware thread.
+	 * @param options
+	 * Options controlling the computation of native quality measures of
+	 * each image. Threads computing images are also obtained from
+	 * `options.executor`, if set.
+	 *
+	 * @return
+	 * Outcome for each image, in the order of `rawImages`.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or loading
+	 * them in the background failed (thrown once all images were
+	 * processed, instead of reporting the error for each image).
+	 *
+	 * @ingroup compute
+	 */
+	std::vector<UnifiedQualityScoreResult> computeUnifiedQualityScores(
+	    const std::vector<NFIQ2::FingerprintImageData> &rawImages,
+	    const unsigned int threadCount,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
+
+	/**
+	 * @brief
+	 * Compute unified quality scores of many images, viewed rather than
+	 * owned.
+	 *
+	 * @details
+	 * Same as computeUnifiedQualityScores(const
+	 * std::vector<NFIQ2::FingerprintImageData> &, const unsigned int)
+	 * const, without copying pixels. Viewed images must outlive the call.
+	 *
+	 * @param rawImages
+	 * Views of fingerprint images.
+	 * @param threadCount
+	 * Maximum number of images computed concurrently. 0 uses one thread
+	 * per hardware thread.
+	 *
+	 * @return
+	 * Outcome for each image, in the order of `rawImages`.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or loading
+	 * them in the background failed.
+	 *
+	 * @ingroup compute
+	 */
+	std::vector<UnifiedQualityScoreResult> computeUnifiedQualityScores(
+	    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+	    const unsigned int threadCount) const;
+
+	/**
+	 * @brief
+	 * Compute unified quality scores of many images, viewed rather than
+	 * owned.
+	 *
+	 * @details
+	 * Same as computeUnifiedQualityScores(const
+	 * std::vector<NFIQ2::FingerprintImageData> &, const unsigned int,
+	 * const NFIQ2::QualityMeasures::ComputationOptions &) const, without
+	 * copying pixels. Viewed images must outlive the call.
+	 *
+	 * @param rawImages
+	 * Views of fingerprint images.
+	 * @param threadCount
+	 * Maximum number of images computed concurrently. 0 uses one thread
+	 * per hardware thread.
+	 * @param options
+	 * Options controlling the computation of native quality measures of
+	 * each image. Threads computing images are also obtained from
+	 * `options.executor`, if set.
+	 *
+	 * @return
+	 * Outcome for each image, in the order of `rawImages`.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, or loading
+	 * them in the background failed.
+	 *
+	 * @ingroup compute
+	 */
+	std::vector<UnifiedQualityScoreResult> computeUnifiedQualityScores(
+	    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+	    const unsigned int threadCount,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
+
+	/**
+	 * @brief
+	 * Obtain the order of native quality measures expected by
+	 * computeUnifiedQualityScores(const std::vector<double> &, const
+	 * unsigned int) const.
+	 *
+	 * @return
+	 * Identifiers of the native quality measures (from
+	 * nfiq2_constants.hpp) a unified quality score is computed from.
+	 */
+	static std::vector<std::string> getUnifiedQualityScoreFeatureOrder();
+
+	/**
+	 * @brief
+	 * Compute unified quality scores from stored native quality measures
+	 * of many images.
+	 *
+	 * @details
+	 * Equivalent to calling
+	 * computeUnifiedQualityScore(const std::unordered_map<std::string,
+	 * double> &) const for each image, but much faster for many images:
+	 * images are evaluated in blocks, one tree of the random forest at a
+	 * time. Blocks are distributed over up to `threadCount` threads,
+	 * including the calling thread.
+	 *
+	 * @param features
+	 * Native quality measures of each image, in the order of
+	 * getUnifiedQualityScoreFeatureOrder(), one image after the other.
+	 * @param threadCount
+	 * Maximum number of threads. 0 uses one thread per hardware thread.
+	 *
+	 * @return
+	 * Unified quality score of each image, in the order of `features`.
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded, size of
+	 * `features` is not a multiple of the number of native quality
+	 * measures, or a score could not be computed.
+	 *
+	 * @ingroup compute
+	 */
+	std::vector<unsigned int> computeUnifiedQualityScores(
+	    const std::vector<double> &features,
+	    const unsigned int threadCount) const;
+
+	/**
+	 * @brief
+	 * Compute a unified quality score asynchronously.
+	 *
+	 * @details
+	 * The score is computed on threads managed by the library, see
+	 * setAsyncLimits(). Images wait in a bounded queue for a thread. When
+	 * the queue is full, this call blocks until an image leaves it, which
+	 * bounds the number of images held at once.
+	 *
+	 * The computation uses the random forest parameters loaded when this
+	 * method is called, and does not require this object to live until
+	 * it finishes.
+	 *
+	 * @param rawImage
+	 * Fingerprint image.
+	 *
+	 * @return
+	 * Future unified quality score. Exceptions thrown during the
+	 * computation are rethrown from std::future::get().
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded.
+	 *
+	 * @note
+	 * Must not be called from a callback running on the library managed
+	 * threads, such as a task of the executor in `options`.
+	 *
+	 * @ingroup compute
+	 */
+	std::future<unsigned int> computeUnifiedQualityScoreAsync(
+	    NFIQ2::FingerprintImageData rawImage) const;
+
+	/**
+	 * @brief
+	 * Compute a unified quality score asynchronously.
+	 *
+	 * @param rawImage
+	 * Fingerprint image.
+	 * @param options
+	 * Options controlling the computation of native quality measures.
+	 *
+	 * @return
+	 * Future unified quality score. Exceptions thrown during the
+	 * computation are rethrown from std::future::get().
+	 *
+	 * @throw Exception
+	 * Called before random forest parameters were loaded.
+	 *
+	 * @ingroup compute
+	 * @see computeUnifiedQualityScoreAsync(FingerprintImageData) const
+	 */
+	std::future<unsigned int> computeUnifiedQualityScoreAsync(
+	    NFIQ2::FingerprintImageData rawImage,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
+
+	/**
+	 * @brief
+	 * Set the limits of the threads computing asynchronous unified
+	 * quality scores.
+	 *
+	 * @details
+	 * Applies to all Algorithm objects. Threads are started on the first
+	 * asynchronous computation after this call. Computations already
+	 * queued still complete; this call waits for them.
+	 *
+	 * @param threadCount
+	 * Number of threads computing scores, 0 (the default) for one per
+	 * hardware thread.
+	 * @param queueCapacity
+	 * Maximum number of images waiting for a thread, 0 (the default) for
+	 * twice the number of threads.
+	 *
+	 * @see computeUnifiedQualityScoreAsync()
+	 */
+	static void setAsyncLimits(
+	    const unsigned int threadCount, const size_t queueCapacity);
+
 	/**
 	 * @brief
 	 * Obtain the quality block values (i.e., [0, 100]) for the native
@@ -206,6 +620,10 @@ class Algorithm {
 	 * @return
 	 * true if some set of random forest parameters have been loaded, false
 	 * otherwise.
+	 *
+	 * @note
+	 * Waits for parameters loading in the background, returning false if
+	 * they could not be loaded.
 	 */
 	bool isInitialized() const;
 
@@ -32,7 +32,8 @@ enum class ErrorCode {
 	FJFX_CannotCreateFeatureSet,
 	FJFX_NoFeatureSetCreated,
 	InvalidUnifiedQualityScore,
-	InvalidImageSize
+	InvalidImageSize,
+	UniformOrEmptyImage
 };
 
 /** Exceptions thrown from NFIQ2 functions. */
@@ -0,0 +1,115 @@
+/*
+ * This file is part of NIST Fingerprint Image Quality (NFIQ) 2. For more
+ * information on this project, refer to:
+ *   - https://nist.gov/services-resources/software/nfiq2
+ *   - https://github.com/usnistgov/NFIQ2
+ *
+ * This work is in the public domain. For complete licensing details, refer to:
+ *   - https://github.com/usnistgov/NFIQ2/blob/master/LICENSE.md
+ */
+
+#ifndef NFIQ2_FINGERPRINTIMAGEVIEW_HPP_
+#define NFIQ2_FINGERPRINTIMAGEVIEW_HPP_
+
+#include <nfiq2_fingerprintimagedata.hpp>
+
+#include <cstdint>
+
+namespace NFIQ2 {
+
+/**
+ * Decompressed fingerprint image in memory owned by someone else,
+ * canonically encoded as per ISO/IEC 39794-4:2019 except that rows may be
+ * followed by padding.
+ *
+ * @details
+ * Computing with a view avoids copying the image into a
+ * FingerprintImageData. The memory must not change or be freed while a
+ * computation using the view runs.
+ */
+class FingerprintImageView {
+    public:
+	/**
+	 * @brief
+	 * Constructor.
+	 *
+	 * @param pixels
+	 * Pointer to the first pixel of the first row of decompressed 8
+	 * bit-per-pixel grayscale image data.
+	 * @param width
+	 * Width of the image in pixels.
+	 * @param height
+	 * Height of the image in pixels.
+	 * @param stride
+	 * Distance in bytes between the first pixels of consecutive rows.
+	 * @param fingerCode
+	 * Finger position of the fingerprint in the image.
+	 * @param ppi
+	 * Resolution of the image in pixels per inch.
+	 *
+	 * @throw NFIQ2::Exception
+	 * `stride` is less than `width`, or `pixels` is null for a non-empty
+	 * image.
+	 */
+	FingerprintImageView(const uint8_t *pixels, uint32_t width,
+	    uint32_t height, uint32_t stride, uint8_t fingerCode, uint16_t ppi);
+
+	/**
+	 * @brief
+	 * Constructor viewing the data of a FingerprintImageData.
+	 *
+	 * @param image
+	 * Image to view, which must outlive the view.
+	 */
+	FingerprintImageView(const NFIQ2::FingerprintImageData &image);
+
+	/** First pixel of the first row of the image. */
+	const uint8_t *pixels { nullptr };
+	/** Width of the fingerprint image in pixels. */
+	uint32_t width { 0 };
+	/** Height of the fingerprint image in pixels. */
+	uint32_t height { 0 };
+	/** Distance in bytes between the starts of consecutive rows. */
+	uint32_t stride { 0 };
+	/** ISO finger code of the fingerprint in the image. */
+	uint8_t fingerCode { 0 };
+	/** Pixels per inch of the fingerprint image. */
+	uint16_t ppi { NFIQ2::FingerprintImageData::Resolution500PPI };
+
+	/**
+	 * @brief
+	 * Obtain a view of the image with near-white lines surrounding the
+	 * fingerprint removed.
+	 *
+	 * @details
+	 * No pixels are copied: the returned view references the memory of
+	 * this view, with the same stride.
+	 *
+	 * @return
+	 * Cropped fingerprint image.
+	 *
+	 * @throws NFIQ2::Exception
+	 * Error performing the crop, or the image is too small to be processed
+	 * after cropping.
+	 */
+	NFIQ2::FingerprintImageView viewRemovingNearWhiteFrame() const;
+
+	/**
+	 * @brief
+	 * Obtain a copy of the image with near-white lines surrounding the
+	 * fingerprint removed.
+	 *
+	 * @return
+	 * Cropped fingerprint image.
+	 *
+	 * @throws NFIQ2::Exception
+	 * Error performing the crop, or the image is too small to be processed
+	 * after cropping.
+	 *
+	 * @see FingerprintImageData::copyRemovingNearWhiteFrame()
+	 */
+	NFIQ2::FingerprintImageData copyRemovingNearWhiteFrame() const;
+};
+} // namespace NFIQ
+
+#endif /* NFIQ2_FINGERPRINTIMAGEVIEW_HPP_ */
@@ -68,6 +68,12 @@ class ModelInfo {
 	 * @brief
 	 * Obtain the file path of the model.
 	 *
+	 * @details
+	 * The model is either random forest parameters in OpenCV's YAML
+	 * format, or a binary random forest converted from them by
+	 * nfiq2-rf-convert. Binary models are memory-mapped and evaluated
+	 * in place, so processes loading the same model share one copy.
+	 *
 	 * @return
 	 * Returns model file path.
 	 */
@@ -77,6 +83,10 @@ class ModelInfo {
 	 * @brief
 	 * Obtain the md5 checksum of the model
 	 *
+	 * @details
+	 * Computed over the bytes of the file at getModelPath(), whatever
+	 * its format.
+	 *
 	 * @return
 	 * Returns model md5 checksum.
 	 */
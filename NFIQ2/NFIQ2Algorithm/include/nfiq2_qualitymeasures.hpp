@@ -13,10 +13,14 @@
 
 #include <nfiq2_constants.hpp>
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace NFIQ2 { namespace QualityMeasures {
 
@@ -29,6 +33,68 @@ namespace NFIQ2 { namespace QualityMeasures {
  */
 class Algorithm;
 
+/**
+ * @brief
+ * Schedules a task for execution, typically on a thread pool.
+ *
+ * @details
+ * Tasks do not throw. A task that is never run only costs parallelism:
+ * the thread requesting the work also works through it. Submitting must
+ * not block (e.g., waiting for room in a bounded queue): submissions are
+ * made from running tasks, and blocking them can deadlock the executor.
+ */
+using Executor = std::function<void(std::function<void()>)>;
+
+/**
+ * @brief
+ * Options controlling how native quality measures are computed.
+ *
+ * @note
+ * Except for rejectUniformOrEmptyImages, options only affect speed.
+ * Computed values are the same for all options.
+ */
+struct ComputationOptions {
+	/**
+	 * Maximum number of native quality measure algorithms computed
+	 * concurrently for an image. 1 computes them one after another on
+	 * the calling thread, 0 uses one thread per hardware thread.
+	 */
+	unsigned int algorithmThreadCount { 1 };
+
+	/**
+	 * Maximum number of threads processing the rows of blocks of a
+	 * block-based native quality measure algorithm concurrently. 1
+	 * processes them one after another on the thread computing the
+	 * algorithm, 0 uses one thread per hardware thread.
+	 */
+	unsigned int blockThreadCount { 1 };
+
+	/**
+	 * Compute the Contrast algorithm first and stop if the image is
+	 * uniform or empty, i.e., its standard deviation is below
+	 * Thresholds::ActionableQualityFeedback::UniformImage or its mean is
+	 * above Thresholds::ActionableQualityFeedback::
+	 * EmptyImageOrContrastTooLow. No other algorithm is computed for
+	 * such images, and an Exception with
+	 * ErrorCode::UniformOrEmptyImage is thrown instead.
+	 *
+	 * @note
+	 * Unlike other options, this changes the outcome for uniform and
+	 * empty images.
+	 */
+	bool rejectUniformOrEmptyImages { false };
+
+	/**
+	 * Executor running concurrent work. When empty, threads are started
+	 * as needed for each image.
+	 *
+	 * @note
+	 * On 32-bit Linux, tasks set the x87 floating point precision of the
+	 * thread running them to double.
+	 */
+	Executor executor {};
+};
+
 /******************************************************************************/
 
 /*
@@ -89,7 +155,105 @@ std::vector<std::string> getNativeQualityMeasureIDs();
  */
 std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 computeNativeQualityMeasureAlgorithms(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage);
+
+/**
+ * @brief
+ * Compute native quality measures.
+ *
+ * @details
+ * Algorithms are computed concurrently as allowed by `options`, except
+ * that minutiae quality waits on minutiae detection and region of interest
+ * coherence waits on region of interest detection.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ * @param options
+ * Options controlling the computation.
+ *
+ * @return
+ * A vector of evaluated native quality measure algorithms, in the same
+ * order as computeNativeQualityMeasureAlgorithms(const
+ * FingerprintImageView&).
+ */
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options);
+
+/**
+ * @brief
+ * Compute selected native quality measures.
+ *
+ * @details
+ * Only the requested algorithms and the algorithms they depend on are
+ * computed: minutiae quality depends on minutiae detection and region of
+ * interest coherence depends on region of interest detection.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ * @param algorithmIDs
+ * Identifiers of the algorithms to compute, from
+ * getNativeQualityMeasureAlgorithmIDs().
+ *
+ * @return
+ * A vector of the requested native quality measure algorithms, evaluated,
+ * in the same order as computeNativeQualityMeasureAlgorithms(const
+ * FingerprintImageView&).
+ *
+ * @throw Exception
+ * `algorithmIDs` contains an unknown identifier.
+ *
+ * @see Identifiers::QualityMeasureAlgorithms
+ */
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs);
+
+/**
+ * @brief
+ * Compute selected native quality measures.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ * @param algorithmIDs
+ * Identifiers of the algorithms to compute, from
+ * getNativeQualityMeasureAlgorithmIDs().
+ * @param options
+ * Options controlling the computation.
+ *
+ * @return
+ * A vector of the requested native quality measure algorithms, evaluated,
+ * in the same order as computeNativeQualityMeasureAlgorithms(const
+ * FingerprintImageView&).
+ *
+ * @throw Exception
+ * `algorithmIDs` contains an unknown identifier.
+ *
+ * @see computeNativeQualityMeasureAlgorithms(const FingerprintImageView&,
+ * const std::unordered_set<std::string>&)
+ */
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options);
+
+/**
+ * @brief
+ * Compute native quality measure values.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ *
+ * @return
+ * A map of quality measure algorithm identifiers to native quality measures.
+ *
+ * @see Identifiers::QualityMeasures
+ */
+std::unordered_map<std::string, double> computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage);
 
 /**
  * @brief
@@ -97,6 +261,8 @@ computeNativeQualityMeasureAlgorithms(
  *
  * @param rawImage
  * Fingerprint image in raw format.
+ * @param options
+ * Options controlling the computation.
  *
  * @return
  * A map of quality measure algorithm identifiers to native quality measures.
@@ -104,7 +270,57 @@ computeNativeQualityMeasureAlgorithms(
  * @see Identifiers::QualityMeasures
  */
 std::unordered_map<std::string, double> computeNativeQualityMeasures(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options);
+
+/**
+ * @brief
+ * Compute native quality measure values of selected algorithms.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ * @param algorithmIDs
+ * Identifiers of the algorithms to compute, from
+ * getNativeQualityMeasureAlgorithmIDs().
+ *
+ * @return
+ * A map of quality measure identifiers to native quality measures of the
+ * requested algorithms.
+ *
+ * @throw Exception
+ * `algorithmIDs` contains an unknown identifier.
+ *
+ * @see Identifiers::QualityMeasures
+ */
+std::unordered_map<std::string, double> computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs);
+
+/**
+ * @brief
+ * Compute native quality measure values of selected algorithms.
+ *
+ * @param rawImage
+ * Fingerprint image in raw format.
+ * @param algorithmIDs
+ * Identifiers of the algorithms to compute, from
+ * getNativeQualityMeasureAlgorithmIDs().
+ * @param options
+ * Options controlling the computation.
+ *
+ * @return
+ * A map of quality measure identifiers to native quality measures of the
+ * requested algorithms.
+ *
+ * @throw Exception
+ * `algorithmIDs` contains an unknown identifier.
+ *
+ * @see Identifiers::QualityMeasures
+ */
+std::unordered_map<std::string, double> computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options);
 
 /**
  * @brief
@@ -120,7 +336,7 @@ std::unordered_map<std::string, double> computeNativeQualityMeasures(
  * @see Thresholds::ActionableQualityFeedback
  */
 std::unordered_map<std::string, double> computeActionableQualityFeedback(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage);
 
 /**@}**************************************************************************/
 
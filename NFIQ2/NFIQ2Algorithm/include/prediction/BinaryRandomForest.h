@@ -0,0 +1,99 @@
+#ifndef NFIQ2_PREDICTION_BINARYRANDOMFOREST_H_
+#define NFIQ2_PREDICTION_BINARYRANDOMFOREST_H_
+
+#include <prediction/FlatRandomForest.h>
+#include <prediction/QuantizedRandomForest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace NFIQ2 { namespace Prediction {
+
+/**
+ * Binary random forest model, evaluated in place from a FlatRandomForest
+ * without parsing.
+ *
+ * @details
+ * A model is a Header, followed by the index of the root node of each
+ * tree (uint32_t), followed by the nodes of all trees
+ * (FlatRandomForest::Node). Integers and floats are stored in the byte
+ * order of the machine that wrote the model, which is recorded in the
+ * header. Models in a different byte order are rejected.
+ *
+ * Since version 2, the nodes are followed by the quantized forest: the
+ * offset of the first threshold of each feature and the total number
+ * of thresholds (featureCount + 1 uint32_t), the thresholds (float),
+ * and the quantized nodes (QuantizedRandomForest::Node). Version 1
+ * models, without quantized forest, are still read.
+ */
+namespace BinaryRandomForest {
+/** Current version of the format */
+static const uint32_t Version { 2 };
+/** Oldest version of the format that can be read */
+static const uint32_t MinimumVersion { 1 };
+/** Value of Header::byteOrder in the byte order of the machine */
+static const uint32_t ByteOrderMark { 0x01020304 };
+
+/** Header of a binary random forest */
+struct Header {
+	/** "NFIQ2RF" followed by a NUL */
+	char magic[8];
+	/** Version of the format */
+	uint32_t version;
+	/** ByteOrderMark, as written by the machine creating the model */
+	uint32_t byteOrder;
+	/** Number of features of a sample */
+	uint32_t featureCount;
+	/** Number of trees */
+	uint32_t treeCount;
+	/** Number of nodes of all trees */
+	uint64_t nodeCount;
+};
+
+/**
+ * @return
+ * true if `data` starts like a binary random forest, regardless of
+ * version.
+ */
+bool isBinaryRandomForest(const uint8_t *data, const size_t size);
+
+/**
+ * @brief
+ * Evaluate a binary random forest in place.
+ *
+ * @param data
+ * Binary random forest, aligned for FlatRandomForest::Node.
+ * @param size
+ * Size of `data` in bytes.
+ * @param storage
+ * Owner of `data`, kept alive by the returned forest.
+ *
+ * @return
+ * Forest referencing the nodes and roots within `data`, evaluated
+ * from the quantized nodes within `data` when present.
+ *
+ * @throw NFIQ2::Exception
+ * `data` is not a valid binary random forest of a supported version
+ * and this byte order.
+ */
+FlatRandomForest read(const uint8_t *data, const size_t size,
+    std::shared_ptr<const void> storage);
+
+/**
+ * @brief
+ * Write a forest as a binary random forest.
+ *
+ * @param out
+ * Stream receiving the model, opened in binary mode.
+ * @param forest
+ * Forest to write. If it cannot be quantized, it is written in version
+ * 1 of the format.
+ */
+void write(std::ostream &out, const FlatRandomForest &forest);
+}
+
+}}
+
+#endif /* NFIQ2_PREDICTION_BINARYRANDOMFOREST_H_ */
@@ -0,0 +1,256 @@
+#ifndef NFIQ2_PREDICTION_FLATRANDOMFOREST_H_
+#define NFIQ2_PREDICTION_FLATRANDOMFOREST_H_
+
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+#include <opencv2/ml.hpp>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace NFIQ2 { namespace Prediction {
+
+class QuantizedRandomForest;
+
+/**
+ * Random forest stored as one contiguous array of nodes, evaluated
+ * without going through OpenCV.
+ *
+ * @details
+ * Trees are stored depth first: the child taken when a feature is less
+ * than or equal to the threshold of a node immediately follows the node,
+ * so only the other child needs to be referenced. Evaluation returns
+ * the same sum of leaf values as cv::ml::DTrees::predict() with
+ * cv::ml::StatModel::RAW_OUTPUT for a two-class forest.
+ *
+ * Forests are evaluated in place from their nodes, unless quantize()
+ * was called.
+ */
+class FlatRandomForest {
+    public:
+	/** Node of a flattened tree */
+	struct Node {
+		/** Split threshold of inner nodes, value of leaves */
+		float value;
+		/**
+		 * Index of the child taken when the feature is greater than
+		 * value (0 for leaves).
+		 */
+		uint32_t greaterChild;
+		/** Index of the feature compared, LeafFeature for leaves */
+		uint16_t feature;
+		/** 1 if a missing feature takes the less or equal child */
+		uint8_t missingLessOrEqual;
+		uint8_t reserved;
+	};
+
+	/** Value of Node::feature for leaves */
+	static const uint16_t LeafFeature { 0xFFFF };
+
+	/** Constructor of an empty forest. */
+	FlatRandomForest() = default;
+
+	/**
+	 * @brief
+	 * Constructor of a forest evaluated in place from nodes stored
+	 * elsewhere.
+	 *
+	 * @param nodes
+	 * Nodes of all trees, laid out as described above.
+	 * @param nodeCount
+	 * Number of nodes.
+	 * @param roots
+	 * Index of the root node of each tree.
+	 * @param treeCount
+	 * Number of trees.
+	 * @param featureCount
+	 * Number of features of a sample.
+	 * @param storage
+	 * Owner of `nodes` and `roots`, kept alive by the forest and its
+	 * copies. Empty if they outlive the forest (e.g., static tables).
+	 *
+	 * @throw NFIQ2::Exception
+	 * Nodes do not form valid trees.
+	 */
+	FlatRandomForest(const Node *nodes, const size_t nodeCount,
+	    const uint32_t *roots, const size_t treeCount,
+	    const unsigned int featureCount,
+	    std::shared_ptr<const void> storage = {});
+
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	/**
+	 * @brief
+	 * Flatten a forest loaded by OpenCV.
+	 *
+	 * @param trees
+	 * Trained forest.
+	 * @param params
+	 * File node the forest was read from, for parameters that
+	 * cv::ml::DTrees does not expose.
+	 *
+	 * @throw NFIQ2::Exception
+	 * The forest uses features that are not supported (categorical
+	 * splits, substitutes for missing values, or leaf values not
+	 * representable as float).
+	 */
+	FlatRandomForest(
+	    const cv::ml::DTrees &trees, const cv::FileNode &params);
+#endif
+
+	/** @return true if the forest has no trees */
+	bool empty() const;
+
+	/** @return Number of trees */
+	unsigned int getTreeCount() const;
+
+	/** @return Number of features of a sample */
+	unsigned int getFeatureCount() const;
+
+	/** @return Nodes of all trees */
+	const Node *getNodes() const;
+
+	/** @return Number of nodes of all trees */
+	size_t getNodeCount() const;
+
+	/** @return Index of the root node of each tree */
+	const uint32_t *getRoots() const;
+
+	/**
+	 * @brief
+	 * Evaluate from a QuantizedRandomForest built from the nodes.
+	 *
+	 * @details
+	 * Results are unchanged, but come from a smaller private copy of
+	 * the nodes. Forests whose nodes are stored elsewhere (mapped
+	 * files, static tables) should store quantized nodes alongside
+	 * and pass them to useQuantized() instead of copying.
+	 *
+	 * @return
+	 * Whether the forest could be quantized. If not, it is still
+	 * evaluated from its nodes.
+	 */
+	bool quantize();
+
+	/**
+	 * @brief
+	 * Evaluate from quantized nodes stored with the nodes.
+	 *
+	 * @param quantized
+	 * Quantized copy of this forest, evaluated in place.
+	 *
+	 * @throw Exception
+	 * `quantized` does not describe the same trees as the nodes.
+	 */
+	void useQuantized(
+	    std::shared_ptr<const QuantizedRandomForest> quantized);
+
+	/** @return Whether evaluation uses quantized nodes */
+	bool isQuantized() const;
+
+	/**
+	 * @brief
+	 * Evaluate all trees for one sample.
+	 *
+	 * @param features
+	 * getFeatureCount() features of the sample. Missing features have the
+	 * value std::numeric_limits<float>::max(), as in OpenCV.
+	 *
+	 * @return
+	 * Sum of the values of the leaves reached, which is the number of
+	 * votes for the second class of a two-class forest.
+	 */
+	float predict(const float *features) const;
+
+	/**
+	 * @brief
+	 * Evaluate all trees for many samples.
+	 *
+	 * @details
+	 * Samples are evaluated in blocks, one tree at a time, so the nodes
+	 * of a tree stay in cache while all samples of a block pass through
+	 * it. Results are identical to calling predict() for each sample.
+	 *
+	 * @param features
+	 * `sampleCount` samples of getFeatureCount() features each, one
+	 * sample after the other.
+	 * @param sampleCount
+	 * Number of samples.
+	 * @param votes
+	 * Receives `sampleCount` results of predict(), in sample order.
+	 */
+	void predict(const float *features, const size_t sampleCount,
+	    float *votes) const;
+
+	/**
+	 * @brief
+	 * Evaluate trees for one sample until a decision on its votes is
+	 * known.
+	 *
+	 * @details
+	 * Trees are evaluated in order. Evaluation stops as soon as `accept`
+	 * returns the same result for the fewest and the most votes the
+	 * remaining trees could add. This is only done when leaf values are
+	 * integers, so that sums are exact whatever the order; otherwise all
+	 * trees are evaluated.
+	 *
+	 * @param features
+	 * getFeatureCount() features of the sample, as for predict().
+	 * @param accept
+	 * Decision on the result of predict(), which must not decrease as
+	 * votes increase.
+	 * @param treesEvaluated
+	 * Receives the number of trees evaluated.
+	 *
+	 * @return
+	 * `accept` of the result of predict().
+	 */
+	bool decide(const float *features,
+	    const std::function<bool(float)> &accept,
+	    unsigned int &treesEvaluated) const;
+
+    private:
+	/** Sum of the fewest and most votes of consecutive trees */
+	struct VoteBounds {
+		double min;
+		double max;
+	};
+
+	/** Compute remainingVotes_ and exactVotes_ */
+	void computeVoteBounds();
+
+	/** @return Index of the leaf of the tree at `root` for `features` */
+	uint32_t findLeaf(const float *features, const uint32_t root) const;
+
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	/** Add the subtree rooted at OpenCV node `nodeIndex` */
+	static uint32_t appendSubtree(const cv::ml::DTrees &trees,
+	    int nodeIndex, const std::vector<int> &featureOfVariable,
+	    const unsigned int featureCount, std::vector<Node> &nodes);
+#endif
+
+	/** Owner of nodes_ and roots_, shared between copies */
+	std::shared_ptr<const void> storage_ {};
+	/** Nodes of all trees */
+	const Node *nodes_ {};
+	/** Number of nodes */
+	size_t nodeCount_ {};
+	/** Index of the root node of each tree */
+	const uint32_t *roots_ {};
+	/** Number of trees */
+	size_t treeCount_ {};
+	/** Number of features of a sample */
+	unsigned int featureCount_ {};
+	/** Votes of the trees from each index on, treeCount_ + 1 entries */
+	std::vector<VoteBounds> remainingVotes_ {};
+	/** Whether all leaf values are integers, so votes sum exactly */
+	bool exactVotes_ {};
+	/** Compact copy of the nodes used for evaluation, see quantize() */
+	std::shared_ptr<const QuantizedRandomForest> quantized_ {};
+};
+
+}}
+
+#endif /* NFIQ2_PREDICTION_FLATRANDOMFOREST_H_ */
@@ -0,0 +1,52 @@
+#ifndef NFIQ2_PREDICTION_MAPPEDFILE_H_
+#define NFIQ2_PREDICTION_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace NFIQ2 { namespace Prediction {
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * @details
+ * Pages are shared through the page cache by every process mapping the
+ * same file, and are only read from disk when first accessed.
+ */
+class MappedFile {
+    public:
+	/**
+	 * @brief
+	 * Constructor mapping a file.
+	 *
+	 * @param path
+	 * Path of the file to map.
+	 *
+	 * @throw NFIQ2::Exception
+	 * The file could not be opened or mapped.
+	 */
+	MappedFile(const std::string &path);
+
+	/** Destructor, unmapping the file. */
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	/** @return Contents of the file, nullptr if the file is empty */
+	const uint8_t *data() const;
+
+	/** @return Size of the file in bytes */
+	size_t size() const;
+
+    private:
+	/** First byte of the mapping */
+	const uint8_t *data_ {};
+	/** Size of the mapping */
+	size_t size_ {};
+};
+
+}}
+
+#endif /* NFIQ2_PREDICTION_MAPPEDFILE_H_ */
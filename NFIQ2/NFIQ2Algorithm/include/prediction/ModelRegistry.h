@@ -0,0 +1,107 @@
+#ifndef NFIQ2_PREDICTION_MODELREGISTRY_H_
+#define NFIQ2_PREDICTION_MODELREGISTRY_H_
+
+#include <prediction/RandomForestML.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace NFIQ2 { namespace Prediction {
+
+/**
+ * Process-wide cache of loaded random forest models, keyed by the source
+ * and hash of their parameters.
+ *
+ * @details
+ * Models are loaded once and shared, read-only, by every
+ * NFIQ2::Algorithm using the same parameters, including copies. A model
+ * is released when the last Algorithm using it is destroyed. All methods
+ * are thread-safe. Concurrent requests for a model wait for a single load,
+ * while other models are obtained without waiting.
+ */
+class ModelRegistry {
+    public:
+	/** Loaded model */
+	struct Model {
+		/** Random forest, shared and never modified */
+		std::shared_ptr<const RandomForestML> forest {};
+		/** MD5 hash of the parameters of forest */
+		std::string parameterHash {};
+	};
+
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
+	/**
+	 * @return
+	 * Model from the parameters embedded in the library.
+	 */
+	static Model getEmbedded();
+#endif
+
+	/**
+	 * @brief
+	 * Obtain the model of a file.
+	 *
+	 * @details
+	 * A model already loaded from `fileName` with hash `fileHash` is
+	 * returned without reading the file.
+	 *
+	 * @param fileName
+	 * Path of the model file.
+	 * @param fileHash
+	 * MD5 hash of the model file.
+	 *
+	 * @throw NFIQ2::Exception
+	 * The file could not be loaded or does not match `fileHash`.
+	 * @throw cv::Exception
+	 * The file could not be parsed.
+	 */
+	static Model get(
+	    const std::string &fileName, const std::string &fileHash);
+
+#ifdef __ANDROID__
+	/**
+	 * @brief
+	 * Obtain the model of an Android asset.
+	 *
+	 * @details
+	 * A model already loaded from asset `fileName` with hash `fileHash`
+	 * is returned without reading the asset.
+	 *
+	 * @param assets
+	 * The Android Asset Manager, provided by the App.
+	 * @param fileName
+	 * Path of the model asset.
+	 * @param fileHash
+	 * MD5 hash of the model asset.
+	 *
+	 * @throw NFIQ2::Exception
+	 * The asset could not be loaded or does not match `fileHash`.
+	 * @throw cv::Exception
+	 * The asset could not be parsed.
+	 */
+	static Model get(AAssetManager *assets, const std::string &fileName,
+	    const std::string &fileHash);
+#endif
+
+    private:
+	/**
+	 * @brief
+	 * Obtain the model registered under `key`, loading it if needed.
+	 *
+	 * @details
+	 * `load` runs without holding the registry lock. Concurrent callers
+	 * with the same `key` wait for its result, or its exception.
+	 *
+	 * @param key
+	 * Key of the model in the registry.
+	 * @param load
+	 * Initializes a RandomForestML and returns its parameter hash.
+	 */
+	static Model getOrLoad(const std::string &key,
+	    const std::function<std::string(RandomForestML &)> &load);
+};
+
+}}
+
+#endif /* NFIQ2_PREDICTION_MODELREGISTRY_H_ */
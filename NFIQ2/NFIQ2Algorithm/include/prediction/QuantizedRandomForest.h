@@ -0,0 +1,190 @@
+#ifndef NFIQ2_PREDICTION_QUANTIZEDRANDOMFOREST_H_
+#define NFIQ2_PREDICTION_QUANTIZEDRANDOMFOREST_H_
+
+#include <prediction/FlatRandomForest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace NFIQ2 { namespace Prediction {
+
+/**
+ * Compact copy of a FlatRandomForest whose split thresholds are replaced
+ * by small integer bins.
+ *
+ * @details
+ * The split thresholds of each feature are sorted and deduplicated. A
+ * feature is quantized once per sample to the number of its thresholds
+ * that are less than it, so that a feature is less than or equal to the
+ * k-th threshold exactly when its bin is less than or equal to k. Nodes
+ * then compare 16-bit bins and fit in 8 bytes, and evaluation gives the
+ * same results as FlatRandomForest for every input.
+ *
+ * Like FlatRandomForest, a quantized forest is either built in memory or
+ * evaluated in place from tables stored elsewhere (binary models,
+ * generated tables). Evaluation allocates nothing; it uses at most
+ * about 10 KiB of stack for bins and sums.
+ */
+class QuantizedRandomForest {
+    public:
+	/** Node of a quantized tree, at the index of the flattened node */
+	struct Node {
+		/**
+		 * Index of the feature compared, with MissingLessOrEqual set
+		 * if a missing feature takes the less or equal child, or
+		 * LeafFeature for leaves.
+		 */
+		uint16_t feature;
+		/** Bin of the split threshold of inner nodes */
+		uint16_t bin;
+		/**
+		 * Index of the child taken when the bin is greater than bin,
+		 * or bit pattern of the float value of leaves.
+		 */
+		uint32_t next;
+	};
+
+	/** Value of Node::feature for leaves */
+	static const uint16_t LeafFeature { 0x7FFF };
+	/** Flag of Node::feature for missing features taking less or equal */
+	static const uint16_t MissingLessOrEqual { 0x8000 };
+	/** Bin of missing features */
+	static const uint16_t MissingBin { 0xFFFF };
+	/** Most features of a sample, so that bins fit on the stack */
+	static const unsigned int MaxFeatureCount { 128 };
+
+	/**
+	 * @brief
+	 * Quantize a flattened forest.
+	 *
+	 * @param forest
+	 * Forest to quantize.
+	 *
+	 * @throw NFIQ2::Exception
+	 * The forest cannot be quantized (more than MaxFeatureCount
+	 * features, too many thresholds, or thresholds that are not a
+	 * number).
+	 */
+	explicit QuantizedRandomForest(const FlatRandomForest &forest);
+
+	/**
+	 * @brief
+	 * Constructor of a quantized forest evaluated in place from tables
+	 * stored elsewhere.
+	 *
+	 * @param nodes
+	 * Nodes of all trees, at the indices of the flattened nodes.
+	 * @param nodeCount
+	 * Number of nodes.
+	 * @param roots
+	 * Index of the root node of each tree.
+	 * @param treeCount
+	 * Number of trees.
+	 * @param thresholds
+	 * Sorted distinct thresholds of all features, one after the other.
+	 * @param thresholdOffsets
+	 * Index in `thresholds` of the first threshold of each feature, and
+	 * the number of thresholds, `featureCount` + 1 entries.
+	 * @param featureCount
+	 * Number of features of a sample.
+	 * @param storage
+	 * Owner of the tables, kept alive by the forest and its copies.
+	 * Empty if they outlive the forest (e.g., static tables).
+	 *
+	 * @throw NFIQ2::Exception
+	 * Tables do not form a valid quantized forest.
+	 */
+	QuantizedRandomForest(const Node *nodes, const size_t nodeCount,
+	    const uint32_t *roots, const size_t treeCount,
+	    const float *thresholds, const uint32_t *thresholdOffsets,
+	    const unsigned int featureCount,
+	    std::shared_ptr<const void> storage = {});
+
+	/** @return Number of features of a sample */
+	unsigned int getFeatureCount() const;
+
+	/** @return Number of trees */
+	unsigned int getTreeCount() const;
+
+	/** @return Index of the root node of each tree */
+	const uint32_t *getRoots() const;
+
+	/** @return Nodes of all trees */
+	const Node *getNodes() const;
+
+	/** @return Number of nodes of all trees */
+	size_t getNodeCount() const;
+
+	/** @return Sorted distinct thresholds of all features */
+	const float *getThresholds() const;
+
+	/**
+	 * @return
+	 * Index of the first threshold of each feature, and the number of
+	 * thresholds, getFeatureCount() + 1 entries.
+	 */
+	const uint32_t *getThresholdOffsets() const;
+
+	/**
+	 * @brief
+	 * Quantize the features of one sample.
+	 *
+	 * @param features
+	 * getFeatureCount() features of the sample, as for
+	 * FlatRandomForest::predict().
+	 * @param bins
+	 * Receives getFeatureCount() bins.
+	 */
+	void quantize(const float *features, uint16_t *bins) const;
+
+	/**
+	 * @return
+	 * Index of the leaf of the tree at `root` for a quantized sample.
+	 */
+	uint32_t findLeaf(const uint16_t *bins, const uint32_t root) const;
+
+	/** @return Value of the leaf at index `leaf` */
+	float getLeafValue(const uint32_t leaf) const;
+
+	/**
+	 * @brief
+	 * Evaluate all trees for one sample.
+	 *
+	 * @return
+	 * Same as FlatRandomForest::predict().
+	 */
+	float predict(const float *features) const;
+
+	/**
+	 * @brief
+	 * Evaluate all trees for many samples.
+	 *
+	 * @details
+	 * Same as FlatRandomForest::predict() for many samples.
+	 */
+	void predict(const float *features, const size_t sampleCount,
+	    float *votes) const;
+
+    private:
+	/** Owner of the tables, shared between copies */
+	std::shared_ptr<const void> storage_ {};
+	/** Index of the root node of each tree */
+	const uint32_t *roots_ {};
+	/** Number of trees */
+	size_t treeCount_ {};
+	/** Nodes of all trees */
+	const Node *nodes_ {};
+	/** Number of nodes */
+	size_t nodeCount_ {};
+	/** Sorted distinct thresholds of all features, one after the other */
+	const float *thresholds_ {};
+	/** Index of the first threshold of each feature, and the end */
+	const uint32_t *thresholdOffsets_ {};
+	/** Number of features of a sample */
+	unsigned int featureCount_ {};
+};
+
+}}
+
+#endif /* NFIQ2_PREDICTION_QUANTIZEDRANDOMFOREST_H_ */
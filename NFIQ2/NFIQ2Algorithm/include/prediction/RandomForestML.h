@@ -2,8 +2,15 @@
 #define NFIQ2_PREDICTION_RANDOMFORESTML_H_
 
 #include <nfiq2_constants.hpp>
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
 #include <opencv2/ml.hpp>
+#endif
+#include <prediction/FlatRandomForest.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -13,7 +20,10 @@
 #include <android/log.h>
 #endif
 
-namespace NFIQ2 { namespace Prediction {
+namespace NFIQ2 {
+struct QualityThresholdResult;
+
+namespace Prediction {
 
 /**
  * This class handles the Random Forest Machine Learning model used
@@ -48,24 +58,89 @@ class RandomForestML {
 #endif
 
 	/**
-	 * Compute NFIQ2 quality score based on model and provided
-	 * QualityFeatureData.
+	 * Compute NFIQ2 quality scores of many samples, each made of
+	 * FeatureCount native quality measures in getFeatureOrder() order,
+	 * one sample after the other.
+	 */
+	void evaluate(const double *features, const size_t sampleCount,
+	    double *qualityValues) const;
+
+	/**
+	 * Decide whether the NFIQ2 quality score of one sample of
+	 * FeatureCount native quality measures, in getFeatureOrder() order,
+	 * is at least `threshold`, evaluating only the trees needed.
+	 */
+	QualityThresholdResult meetsQualityThreshold(const double *features,
+	    const unsigned int threshold) const;
+
+	/** Number of native quality measures the model is evaluated on. */
+	static const unsigned int FeatureCount { 69 };
+
+	/** Identifiers of native quality measures, in model order. */
+	using FeatureOrder = std::array<std::string, FeatureCount>;
+
+	/**
+	 * Returns identifiers of the native quality measures in the order
+	 * the model expects them.
 	 */
-	void evaluate(const std::unordered_map<std::string, double> &features,
-	    double &qualityValue) const;
+	static const FeatureOrder &getFeatureOrder();
+
+	/**
+	 * @brief
+	 * Scale the votes of the forest to a unified quality score.
+	 *
+	 * @param raw_prediction
+	 * Number of trees voting for good quality.
+	 * @param max_trees
+	 * Number of trees.
+	 *
+	 * @return
+	 * Unified quality score.
+	 *
+	 * @throw NFIQ2::Exception
+	 * Score is out of range.
+	 */
+	static double computeQualityValue(
+	    const float raw_prediction, const float max_trees);
 
     private:
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
 	/** OpenCV shared smart pointer referring to the RF model itself. */
 	cv::Ptr<cv::ml::RTrees> m_pTrainedRF;
+#endif
+	/**
+	 * Flattened copy of the model used for prediction, empty when the
+	 * model cannot be flattened and OpenCV predicts instead.
+	 */
+	FlatRandomForest m_flatRF;
+	/** Throws if no trained model has been loaded. */
+	void throwIfUntrained() const;
+	/** Whether predictions use m_flatRF rather than OpenCV. */
+	bool useFlatForest() const;
+	/** Returns the number of trees voting for one sample. */
+	float predictVotes(const float *sample) const;
+	/** Computes the votes of many samples. */
+	void predictVotes(const float *samples, const size_t sampleCount,
+	    float *votes) const;
+	/** Returns the number of trees. */
+	float getTreeCount() const;
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
 	/** Calculates the hash of the RandomForest parameters. */
-	std::string calculateHashString(const std::string &s);
+	std::string calculateHashString(const void *data, const size_t size);
 	/** Initialize model using string parameters. */
 	void initModule(const std::string &params);
+	/**
+	 * Initialize model from the contents of a model file, either YAML
+	 * or a binary random forest evaluated in place from `storage`.
+	 */
+	void initModule(const uint8_t *data, const size_t size,
+	    std::shared_ptr<const void> storage);
 
 #ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
 	/** Extracts string parameters when model is embedded. */
 	std::string joinRFTrainedParamsString();
 #endif
+#endif /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
 };
 
 }}
@@ -1,7 +1,8 @@
 #ifndef NFIQ2_QUALITYMODULES_FDA_H_
 #define NFIQ2_QUALITYMODULES_FDA_H_
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -20,7 +21,8 @@ static double FDAHISTLIMITS[9] = { 0.268, 0.304, 0.33, 0.355, 0.38, 0.407, 0.44,
 
 class FDA : public Algorithm {
     public:
-	FDA(const NFIQ2::FingerprintImageData &fingerprintImage);
+	FDA(const NFIQ2::FingerprintImageView &fingerprintImage);
+	FDA(const FeatureContext &context);
 	virtual ~FDA();
 
 	std::string getName() const override;
@@ -29,11 +31,10 @@ class FDA : public Algorithm {
 	static const char moduleName[];
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 
 	const int blocksize { Sizes::LocalRegionSquare };
-	const double threshold { .1 };
 	const int slantedBlockSizeX {
 		Sizes::VerticallyAlignedLocalRegionWidth
 	};
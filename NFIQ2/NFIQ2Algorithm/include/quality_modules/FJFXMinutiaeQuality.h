@@ -2,7 +2,7 @@
 #define NFIQ2_QUALITYMODULES_FINGERJETFXMINUTIAEQUALITY_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <quality_modules/FingerJetFX.h>
@@ -28,7 +28,7 @@ class FJFXMinutiaeQuality : public Algorithm {
 		double quality; ///< computed minutiae quality value
 	};
 
-	FJFXMinutiaeQuality(const NFIQ2::FingerprintImageData &fingerprintImage,
+	FJFXMinutiaeQuality(const NFIQ2::FingerprintImageView &fingerprintImage,
 	    const std::vector<FingerJetFX::Minutia> &minutiaData);
 
 	virtual ~FJFXMinutiaeQuality();
@@ -43,18 +43,18 @@ class FJFXMinutiaeQuality : public Algorithm {
 	std::vector<FingerJetFX::Minutia> getMinutiaData() const;
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	std::vector<FingerJetFX::Minutia> minutiaData_ {};
 	std::vector<MinutiaData> computeMuMinQuality(int bs,
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	std::vector<MinutiaData> computeOCLMinQuality(int bs,
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	double computeMMBBasedOnCOM(int bs,
-	    const NFIQ2::FingerprintImageData &fingerprintImage,
+	    const NFIQ2::FingerprintImageView &fingerprintImage,
 	    unsigned int regionSize);
 };
 
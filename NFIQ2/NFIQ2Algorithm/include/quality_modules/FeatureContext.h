@@ -0,0 +1,191 @@
+#ifndef NFIQ2_QUALITYMODULES_FEATURECONTEXT_H_
+#define NFIQ2_QUALITYMODULES_FEATURECONTEXT_H_
+
+#include <nfiq2_constants.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <opencv2/core.hpp>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace NFIQ2 { namespace QualityMeasures {
+
+/**
+******************************************************************************
+* @class FeatureContext
+* @brief Per-image intermediate results shared between quality modules.
+*
+* @details
+* Several quality modules (FDA, LCS, OF, RVUP) start with the same
+* preprocessing of the cropped fingerprint image: ridge segmentation and
+* the local ridge orientation of every Sizes::LocalRegionSquare block of
+* a common block grid. A FeatureContext is built once per image and hands
+* out those results, computing each of them at most once, on first
+* request. Accessors may be called concurrently.
+*
+* The context also decides whether block loops of the modules run
+* concurrently, see parallelFor().
+*
+* The context only references the pixels of the fingerprint image, which
+* must outlive it.
+******************************************************************************/
+class FeatureContext {
+    public:
+	/** Local ridge orientation of one block of the block grid */
+	struct BlockOrientation {
+		/** Covariance coefficients of the gradients (covcoef()) */
+		double cova {};
+		double covb {};
+		double covc {};
+		/** Ridge orientation in radians (ridgeorient()) */
+		double orientation {};
+		/** 1 if the entire block is foreground (allfun()) */
+		uint8_t foreground {};
+	};
+
+	/**
+	 * Runs a task once for each index in [0, count), possibly
+	 * concurrently, and returns when all have run.
+	 */
+	using ParallelFor = std::function<void(
+	    int count, const std::function<void(int)> &task)>;
+
+	/**
+	 * @brief
+	 * Constructor.
+	 *
+	 * @param fingerprintImage
+	 * Cropped fingerprint image.
+	 * @param parallelFor
+	 * Runs block loops. When empty, block loops run serially on the
+	 * calling thread.
+	 */
+	FeatureContext(const NFIQ2::FingerprintImageView &fingerprintImage,
+	    ParallelFor parallelFor = nullptr);
+
+	FeatureContext(const FeatureContext &) = delete;
+	FeatureContext &operator=(const FeatureContext &) = delete;
+
+	/** @return Fingerprint image the context was built for */
+	const NFIQ2::FingerprintImageView &getFingerprintImage() const;
+
+	/**
+	 * @brief
+	 * Obtain the ridge segmentation mask of the image.
+	 *
+	 * @details
+	 * Result of ridgesegment() with blocks of
+	 * Sizes::LocalRegionSquare pixels and a standard deviation
+	 * threshold of 0.1.
+	 *
+	 * @return
+	 * CV_8UC1 mask the size of the image, 255 for foreground pixels, 0
+	 * otherwise.
+	 *
+	 * @throw cv::Exception
+	 * Mask could not be computed.
+	 */
+	const cv::Mat &getRidgeSegmentMask() const;
+
+	/**
+	 * @return
+	 * Offset in pixels of the first block of the block grid from the
+	 * top and left image borders. Blocks are preceded by this border so
+	 * that a slanted block of Sizes::VerticallyAlignedLocalRegionWidth by
+	 * Sizes::VerticallyAlignedLocalRegionHeight pixels can be rotated
+	 * within it.
+	 */
+	int getBlockOffset() const;
+
+	/** @return Number of block rows of the block grid */
+	int getBlockRows() const;
+
+	/** @return Number of block columns of the block grid */
+	int getBlockCols() const;
+
+	/**
+	 * @brief
+	 * Compute the local ridge orientation of every block of the block
+	 * grid, if not done yet.
+	 *
+	 * @details
+	 * The computation runs block rows through parallelFor(). Modules
+	 * call this before their own block loops, so that tasks of those
+	 * loops only read orientations, rather than waiting for the
+	 * computation while holding a thread that could contribute to it.
+	 *
+	 * @throw cv::Exception
+	 * Orientations could not be computed.
+	 */
+	void computeBlockOrientations() const;
+
+	/**
+	 * @brief
+	 * Obtain the local ridge orientation of a block.
+	 *
+	 * @details
+	 * The block in grid row `blockRow` and grid column `blockCol` covers
+	 * the Sizes::LocalRegionSquare pixels square starting at
+	 * getBlockOffset() + blockRow * Sizes::LocalRegionSquare,
+	 * getBlockOffset() + blockCol * Sizes::LocalRegionSquare. Values
+	 * are computed for all blocks of the grid, foreground or not, by
+	 * computeBlockOrientations(), which must be called first when this
+	 * is called from tasks of parallelFor().
+	 *
+	 * @param blockRow
+	 * Row of the block in the block grid.
+	 * @param blockCol
+	 * Column of the block in the block grid.
+	 *
+	 * @return
+	 * Local ridge orientation of the block.
+	 *
+	 * @throw cv::Exception
+	 * Orientations could not be computed.
+	 */
+	const BlockOrientation &getBlockOrientation(
+	    int blockRow, int blockCol) const;
+
+	/**
+	 * @brief
+	 * Run `task` once for each index in [0, `count`).
+	 *
+	 * @details
+	 * Tasks may run concurrently and in any order, so each must only
+	 * write results that belong to its own index. Callers combine those
+	 * results in index order afterwards to stay independent of
+	 * scheduling.
+	 *
+	 * @param count
+	 * Number of indices, typically block rows.
+	 * @param task
+	 * Task to run for each index.
+	 *
+	 * @throw
+	 * Exception thrown by `task` for the lowest index.
+	 */
+	void parallelFor(
+	    const int count, const std::function<void(int)> &task) const;
+
+    private:
+	const NFIQ2::FingerprintImageView fingerprintImage_;
+	const ParallelFor parallelFor_;
+
+	int blockOffset_ {};
+	int blockRows_ {};
+	int blockCols_ {};
+
+	mutable std::once_flag ridgeSegmentMaskFlag_ {};
+	mutable cv::Mat ridgeSegmentMask_ {};
+
+	mutable std::once_flag blockOrientationsFlag_ {};
+	/** Orientations of all blocks, in row-major order */
+	mutable std::vector<BlockOrientation> blockOrientations_ {};
+};
+
+}}
+
+#endif /* NFIQ2_QUALITYMODULES_FEATURECONTEXT_H_ */
+
+/******************************************************************************/
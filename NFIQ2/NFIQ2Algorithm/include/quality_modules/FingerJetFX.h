@@ -2,7 +2,7 @@
 #define NFIQ2_QUALITYMODULES_FINGERJETFX_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <quality_modules/Module.h>
 
 #include "FRFXLL.h"
@@ -99,7 +99,7 @@ class FingerJetFX : public Algorithm {
 					     ///< the defined circle
 	};
 
-	FingerJetFX(const NFIQ2::FingerprintImageData &fingerprintImage);
+	FingerJetFX(const NFIQ2::FingerprintImageView &fingerprintImage);
 	virtual ~FingerJetFX();
 
 	std::string getName() const override;
@@ -114,8 +114,8 @@ class FingerJetFX : public Algorithm {
 	std::vector<FingerJetFX::Minutia> getMinutiaData() const;
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	FRFXLL_RESULT
 	createContext(FRFXLL_HANDLE_PT phContext);
@@ -123,7 +123,7 @@ class FingerJetFX : public Algorithm {
 	std::vector<FingerJetFX::Minutia> minutiaData_ {};
 
 	FJFXROIResults computeROI(int bs,
-	    const NFIQ2::FingerprintImageData &fingerprintImage,
+	    const NFIQ2::FingerprintImageView &fingerprintImage,
 	    std::vector<FingerJetFX::Object> vecRectDimensions);
 };
 }}
@@ -2,7 +2,7 @@
 #define NFIQ2_QUALITYMODULES_IMGPROCROI_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <opencv2/core.hpp>
 #include <quality_modules/Module.h>
 
@@ -35,7 +35,7 @@ class ImgProcROI : public Algorithm {
 		double stdDevOfROIPixels {};
 	};
 
-	ImgProcROI(const NFIQ2::FingerprintImageData &fingerprintImage);
+	ImgProcROI(const NFIQ2::FingerprintImageView &fingerprintImage);
 	virtual ~ImgProcROI();
 
 	std::string getName() const override;
@@ -50,8 +50,8 @@ class ImgProcROI : public Algorithm {
 	ImgProcROIResults getImgProcResults();
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	ImgProcROIResults imgProcResults_ {};
 	bool imgProcComputed_ { false };
@@ -2,7 +2,8 @@
 #define NFIQ2_QUALITYMODULES_LCS_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -15,7 +16,8 @@ static double LCSHISTLIMITS[9] = { 0, 0.70, 0.74, 0.77, 0.79, 0.81, 0.83, 0.85,
 
 class LCS : public Algorithm {
     public:
-	LCS(const NFIQ2::FingerprintImageData &fingerprintImage);
+	LCS(const NFIQ2::FingerprintImageView &fingerprintImage);
+	LCS(const FeatureContext &context);
 	virtual ~LCS();
 
 	std::string getName() const override;
@@ -23,11 +25,10 @@ class LCS : public Algorithm {
 	static std::vector<std::string> getNativeQualityMeasureIDs();
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 
 	const int blocksize { Sizes::LocalRegionSquare };
-	const double threshold { .1 };
 	const int scannerRes { 500 };
 	const bool padFlag { false };
 };
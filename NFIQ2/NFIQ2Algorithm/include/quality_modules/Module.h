@@ -3,6 +3,7 @@
 
 #include <nfiq2_constants.hpp>
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <quality_modules/NativeQualityMeasures.h>
 
 #include <string>
 #include <unordered_map>
@@ -21,19 +22,24 @@ class Algorithm {
 	/** @return computed quality feature speed */
 	virtual double getSpeed() const;
 
-	/** @return computed quality features */
+	/**
+	 * @return computed quality features, keyed by identifier
+	 * @note Built on each call, prefer getFeatureVector() internally.
+	 */
 	virtual std::unordered_map<std::string, double> getFeatures() const;
 
+	/** @return computed quality features, by index */
+	const NativeQualityMeasureVector &getFeatureVector() const;
+
     protected:
 	void setSpeed(const double featureSpeed);
 
-	void setFeatures(
-	    const std::unordered_map<std::string, double> &featureResult);
+	void setFeatures(const NativeQualityMeasureVector &featureResult);
 
     private:
 	double speed {};
 
-	std::unordered_map<std::string, double> features {};
+	NativeQualityMeasureVector features {};
 };
 
 }}
@@ -2,7 +2,7 @@
 #define NFIQ2_QUALITYMODULES_MU_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -12,7 +12,7 @@ namespace NFIQ2 { namespace QualityMeasures {
 
 class Mu : public Algorithm {
     public:
-	Mu(const NFIQ2::FingerprintImageData &fingerprintImage);
+	Mu(const NFIQ2::FingerprintImageView &fingerprintImage);
 	virtual ~Mu();
 
 	std::string getName() const override;
@@ -25,8 +25,8 @@ class Mu : public Algorithm {
 	static std::vector<std::string> getNativeQualityMeasureIDs();
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const NFIQ2::FingerprintImageView &fingerprintImage);
 
 	bool sigmaComputed { false };
 	double sigma {};
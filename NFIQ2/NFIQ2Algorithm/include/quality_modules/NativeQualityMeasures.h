@@ -0,0 +1,171 @@
+#ifndef NFIQ2_QUALITYMODULES_NATIVEQUALITYMEASURES_H_
+#define NFIQ2_QUALITYMODULES_NATIVEQUALITYMEASURES_H_
+
+#include <array>
+#include <bitset>
+#include <string>
+#include <unordered_map>
+
+namespace NFIQ2 { namespace QualityMeasures {
+
+/**
+ * Position of each native quality measure of
+ * NFIQ2::Identifiers::QualityMeasures in a NativeQualityMeasureVector,
+ * which is the order the random forest expects them in.
+ */
+namespace NativeQualityMeasureIndex {
+/** Number of native quality measures */
+constexpr unsigned int Count { 69 };
+
+namespace FrequencyDomainAnalysis {
+namespace Histogram {
+constexpr unsigned int Bin0 { 0 };
+constexpr unsigned int Bin1 { 1 };
+constexpr unsigned int Bin2 { 2 };
+constexpr unsigned int Bin3 { 3 };
+constexpr unsigned int Bin4 { 4 };
+constexpr unsigned int Bin5 { 5 };
+constexpr unsigned int Bin6 { 6 };
+constexpr unsigned int Bin7 { 7 };
+constexpr unsigned int Bin8 { 8 };
+constexpr unsigned int Bin9 { 9 };
+}
+constexpr unsigned int Mean { 10 };
+constexpr unsigned int StdDev { 11 };
+}
+namespace Minutiae {
+constexpr unsigned int CountCOM { 12 };
+constexpr unsigned int Count { 13 };
+constexpr unsigned int PercentImageMean50 { 14 };
+constexpr unsigned int PercentOrientationCertainty80 { 15 };
+}
+namespace RegionOfInterest {
+constexpr unsigned int Mean { 16 };
+constexpr unsigned int CoherenceMean { 55 };
+constexpr unsigned int CoherenceSum { 56 };
+}
+namespace LocalClarity {
+namespace Histogram {
+constexpr unsigned int Bin0 { 17 };
+constexpr unsigned int Bin1 { 18 };
+constexpr unsigned int Bin2 { 19 };
+constexpr unsigned int Bin3 { 20 };
+constexpr unsigned int Bin4 { 21 };
+constexpr unsigned int Bin5 { 22 };
+constexpr unsigned int Bin6 { 23 };
+constexpr unsigned int Bin7 { 24 };
+constexpr unsigned int Bin8 { 25 };
+constexpr unsigned int Bin9 { 26 };
+}
+constexpr unsigned int Mean { 27 };
+constexpr unsigned int StdDev { 28 };
+}
+namespace Contrast {
+constexpr unsigned int MeanOfBlockMeans { 29 };
+constexpr unsigned int ImageMean { 30 };
+}
+namespace OrientationCertainty {
+namespace Histogram {
+constexpr unsigned int Bin0 { 31 };
+constexpr unsigned int Bin1 { 32 };
+constexpr unsigned int Bin2 { 33 };
+constexpr unsigned int Bin3 { 34 };
+constexpr unsigned int Bin4 { 35 };
+constexpr unsigned int Bin5 { 36 };
+constexpr unsigned int Bin6 { 37 };
+constexpr unsigned int Bin7 { 38 };
+constexpr unsigned int Bin8 { 39 };
+constexpr unsigned int Bin9 { 40 };
+}
+constexpr unsigned int Mean { 41 };
+constexpr unsigned int StdDev { 42 };
+}
+namespace OrientationFlow {
+namespace Histogram {
+constexpr unsigned int Bin0 { 43 };
+constexpr unsigned int Bin1 { 44 };
+constexpr unsigned int Bin2 { 45 };
+constexpr unsigned int Bin3 { 46 };
+constexpr unsigned int Bin4 { 47 };
+constexpr unsigned int Bin5 { 48 };
+constexpr unsigned int Bin6 { 49 };
+constexpr unsigned int Bin7 { 50 };
+constexpr unsigned int Bin8 { 51 };
+constexpr unsigned int Bin9 { 52 };
+}
+constexpr unsigned int Mean { 53 };
+constexpr unsigned int StdDev { 54 };
+}
+namespace RidgeValleyUniformity {
+namespace Histogram {
+constexpr unsigned int Bin0 { 57 };
+constexpr unsigned int Bin1 { 58 };
+constexpr unsigned int Bin2 { 59 };
+constexpr unsigned int Bin3 { 60 };
+constexpr unsigned int Bin4 { 61 };
+constexpr unsigned int Bin5 { 62 };
+constexpr unsigned int Bin6 { 63 };
+constexpr unsigned int Bin7 { 64 };
+constexpr unsigned int Bin8 { 65 };
+constexpr unsigned int Bin9 { 66 };
+}
+constexpr unsigned int Mean { 67 };
+constexpr unsigned int StdDev { 68 };
+}
+}
+
+/**
+ * Native quality measures stored by NativeQualityMeasureIndex rather than
+ * by identifier, so that they can be computed, combined and evaluated
+ * without hashing strings.
+ */
+class NativeQualityMeasureVector {
+    public:
+	/** Set the native quality measure at `index` */
+	void set(const unsigned int index, const double value);
+
+	/** @return Whether the native quality measure at `index` is set */
+	bool has(const unsigned int index) const;
+
+	/** @return true if no native quality measure is set */
+	bool empty() const;
+
+	/** @return Index of the first measure not set, Count if none */
+	unsigned int firstMissing() const;
+
+	/** Set the native quality measures set in `other` */
+	void merge(const NativeQualityMeasureVector &other);
+
+	/**
+	 * @return
+	 * All native quality measures, in NativeQualityMeasureIndex order.
+	 * Measures not set are 0.
+	 */
+	const double *data() const;
+
+	/** @return Native quality measures set, keyed by identifier */
+	std::unordered_map<std::string, double> toMap() const;
+
+	/**
+	 * @return
+	 * Native quality measures of `map` whose identifiers are known.
+	 */
+	static NativeQualityMeasureVector fromMap(
+	    const std::unordered_map<std::string, double> &map);
+
+	/**
+	 * @return
+	 * Identifier of the native quality measure at `index`.
+	 */
+	static const char *getIdentifier(const unsigned int index);
+
+    private:
+	/** Values of native quality measures, by index */
+	std::array<double, NativeQualityMeasureIndex::Count> values {};
+	/** Whether each value has been set */
+	std::bitset<NativeQualityMeasureIndex::Count> present {};
+};
+
+}}
+
+#endif /* NFIQ2_QUALITYMODULES_NATIVEQUALITYMEASURES_H_ */
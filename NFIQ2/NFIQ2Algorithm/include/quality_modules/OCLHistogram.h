@@ -4,8 +4,9 @@
 #define BS_OCL NFIQ2::Sizes::LocalRegionSquare // block size for OCL
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <opencv2/core.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -18,7 +19,8 @@ static double OCLPHISTLIMITS[9] = { 0.337, 0.479, 0.579, 0.655, 0.716, 0.766,
 
 class OCLHistogram : public Algorithm {
     public:
-	OCLHistogram(const NFIQ2::FingerprintImageData &fingerprintImage);
+	OCLHistogram(const NFIQ2::FingerprintImageView &fingerprintImage);
+	OCLHistogram(const FeatureContext &context);
 	virtual ~OCLHistogram();
 
 	std::string getName() const override;
@@ -29,8 +31,8 @@ class OCLHistogram : public Algorithm {
 	static bool getOCLValueOfBlock(const cv::Mat &block, double &ocl);
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 };
 
 }}
@@ -2,7 +2,8 @@
 #define NFIQ2_QUALITYMODULES_OF_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -21,7 +22,8 @@ static double OFHISTLIMITS[9] = { 1.715e-2, 3.5e-2, 5.57e-2, 8.1e-2, 1.15e-1,
 
 class OF : public Algorithm {
     public:
-	OF(const NFIQ2::FingerprintImageData &fingerprintImage);
+	OF(const NFIQ2::FingerprintImageView &fingerprintImage);
+	OF(const FeatureContext &context);
 	virtual ~OF();
 
 	std::string getName() const override;
@@ -32,21 +34,8 @@ class OF : public Algorithm {
 	static constexpr double angleMin { 4.0 };
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
-
-	/** Processing is done in subblocks of this size. */
-	const int blocksize { Sizes::LocalRegionSquare };
-	/** Size of the rotated block in the x dimension */
-	const int slantedBlockSizeX {
-		Sizes::VerticallyAlignedLocalRegionWidth
-	};
-	/** Size of the rotated block in the y dimension */
-	const int slantedBlockSizeY {
-		Sizes::VerticallyAlignedLocalRegionHeight
-	};
-	/**Threshold for differentiating foreground/background blocks */
-	const double threshold { .1 };
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 };
 }}
 
@@ -2,8 +2,9 @@
 #define NFIQ2_QUALITYMODULES_QUALITYMAP_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <opencv2/core.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include "ImgProcROI.h"
@@ -19,7 +20,9 @@ namespace NFIQ2 { namespace QualityMeasures {
 
 class QualityMap : public Algorithm {
     public:
-	QualityMap(const NFIQ2::FingerprintImageData &fingerprintImage,
+	QualityMap(const NFIQ2::FingerprintImageView &fingerprintImage,
+	    const ImgProcROI::ImgProcROIResults &imgProcResults);
+	QualityMap(const FeatureContext &context,
 	    const ImgProcROI::ImgProcROIResults &imgProcResults);
 	virtual ~QualityMap();
 
@@ -42,8 +45,9 @@ class QualityMap : public Algorithm {
 	    unsigned int &noOfHighFlowBlocks, unsigned int &noOfLowFlowBlocks);
 
 	// compute orientation map
-	static cv::Mat computeOrientationMap(cv::Mat &img, bool bFilterByROI,
-	    double &coherenceSum, double &coherenceRel, unsigned int bs,
+	static cv::Mat computeOrientationMap(const FeatureContext &context,
+	    cv::Mat &img, bool bFilterByROI, double &coherenceSum,
+	    double &coherenceRel, unsigned int bs,
 	    ImgProcROI::ImgProcROIResults roiResults);
 
 	// static helper functions for numberical gradient computation
@@ -52,8 +56,8 @@ class QualityMap : public Algorithm {
 	    cv::Mat &grad_x, cv::Mat &grad_y);
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 
 	ImgProcROI::ImgProcROIResults imgProcResults_ {};
 };
@@ -2,7 +2,8 @@
 #define NFIQ2_QUALITYMODULES_RVUPHISTOGRAM_H_
 
 #include <nfiq2_constants.hpp>
-#include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/Module.h>
 
 #include <string>
@@ -14,7 +15,8 @@ static double RVUPHISTLIMITS[9] = { 0.5, 0.667, 0.8, 1, 1.25, 1.5, 2, 24, 30 };
 
 class RVUPHistogram : public Algorithm {
     public:
-	RVUPHistogram(const NFIQ2::FingerprintImageData &fingerprintImage);
+	RVUPHistogram(const NFIQ2::FingerprintImageView &fingerprintImage);
+	RVUPHistogram(const FeatureContext &context);
 	virtual ~RVUPHistogram();
 
 	std::string getName() const override;
@@ -22,11 +24,10 @@ class RVUPHistogram : public Algorithm {
 	static std::vector<std::string> getNativeQualityMeasureIDs();
 
     private:
-	std::unordered_map<std::string, double> computeFeatureData(
-	    const NFIQ2::FingerprintImageData &fingerprintImage);
+	NativeQualityMeasureVector computeFeatureData(
+	    const FeatureContext &context);
 
 	const int blocksize { Sizes::LocalRegionSquare };
-	const double threshold { .1 };
 	const int slantedBlockSizeX {
 		Sizes::VerticallyAlignedLocalRegionWidth
 	};
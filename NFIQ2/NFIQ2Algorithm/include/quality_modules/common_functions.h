@@ -3,6 +3,7 @@
 
 #include <nfiq2_constants.hpp>
 #include <opencv2/core.hpp>
+#include <quality_modules/NativeQualityMeasures.h>
 
 #include <unordered_map>
 
@@ -29,6 +30,10 @@ uint8_t allfun(const cv::Mat &image);
 
 void getRotatedBlock(const cv::Mat &block, const double orientation,
     bool padFlag, cv::Mat &rotatedBlock);
+/* Only rows and cols of the rotated block */
+void getRotatedBlock(const cv::Mat &block, const double orientation,
+    bool padFlag, const cv::Range &rows, const cv::Range &cols,
+    cv::Mat &rotatedBlock);
 
 void getRidgeValleyStructure(const cv::Mat &blockCropped,
     std::vector<uint8_t> &ridval, std::vector<double> &dt);
@@ -45,10 +50,15 @@ cv::Mat computeNumericalGradientX(const cv::Mat &mat);
 void computeNumericalGradients(const cv::Mat &mat, cv::Mat &grad_x,
     cv::Mat &grad_y);
 
-void
-addHistogramFeatures(std::unordered_map<std::string, double> &featureDataList,
-    std::string featurePrefix, std::vector<double> &binBoundaries,
-    std::vector<double> &dataVector, int binCount);
+/**
+ * @brief
+ * Add the histogram, mean and standard deviation of `dataVector` to
+ * `featureDataList`, from index `firstIndex` on.
+ */
+void addHistogramFeatures(NativeQualityMeasureVector &featureDataList,
+    const unsigned int firstIndex, std::string featurePrefix,
+    std::vector<double> &binBoundaries, std::vector<double> &dataVector,
+    int binCount);
 void addSamplingFeatureNames(std::vector<std::string> &featureNames,
     const char *prefix);
 void addHistogramFeatureNames(std::vector<std::string> &featureNames,
@@ -2,21 +2,39 @@
 #include <nfiq2_modelinfo.hpp>
 
 #include "nfiq2_algorithm_impl.hpp"
+#include <utility>
 
 NFIQ2::Algorithm::Algorithm()
-    : pimpl { new NFIQ2::Algorithm::Impl() }
+    : NFIQ2::Algorithm { ModelLoading::Immediate }
+{
+}
+
+NFIQ2::Algorithm::Algorithm(const ModelLoading loading)
+    : pimpl { new NFIQ2::Algorithm::Impl(loading) }
 {
 }
 
 NFIQ2::Algorithm::Algorithm(const std::string &fileName,
     const std::string &fileHash)
-    : pimpl { new NFIQ2::Algorithm::Impl(fileName, fileHash) }
+    : NFIQ2::Algorithm { fileName, fileHash, ModelLoading::Immediate }
+{
+}
+
+NFIQ2::Algorithm::Algorithm(const std::string &fileName,
+    const std::string &fileHash, const ModelLoading loading)
+    : pimpl { new NFIQ2::Algorithm::Impl(fileName, fileHash, loading) }
 {
 }
 
 NFIQ2::Algorithm::Algorithm(const NFIQ2::ModelInfo &modelInfoObj)
+    : NFIQ2::Algorithm { modelInfoObj, ModelLoading::Immediate }
+{
+}
+
+NFIQ2::Algorithm::Algorithm(const NFIQ2::ModelInfo &modelInfoObj,
+    const ModelLoading loading)
     : NFIQ2::Algorithm { modelInfoObj.getModelPath(),
-	    modelInfoObj.getModelHash() }
+	    modelInfoObj.getModelHash(), loading }
 {
 }
 
@@ -42,11 +60,19 @@ NFIQ2::Algorithm::operator=(const Algorithm &rhs)
 
 unsigned int
 NFIQ2::Algorithm::computeUnifiedQualityScore(
-    const NFIQ2::FingerprintImageData &rawImage) const
+    const NFIQ2::FingerprintImageView &rawImage) const
 {
 	return (this->pimpl->computeUnifiedQualityScore(rawImage));
 }
 
+unsigned int
+NFIQ2::Algorithm::computeUnifiedQualityScore(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	return (this->pimpl->computeUnifiedQualityScore(rawImage, options));
+}
+
 unsigned int
 NFIQ2::Algorithm::computeUnifiedQualityScore(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
@@ -62,6 +88,102 @@ NFIQ2::Algorithm::computeUnifiedQualityScore(
 	return (this->pimpl->computeUnifiedQualityScore(features));
 }
 
+NFIQ2::QualityThresholdResult
+NFIQ2::Algorithm::meetsQualityThreshold(
+    const std::unordered_map<std::string, double> &features,
+    const unsigned int threshold) const
+{
+	return (this->pimpl->meetsQualityThreshold(features, threshold));
+}
+
+NFIQ2::QualityThresholdResult
+NFIQ2::Algorithm::meetsQualityThreshold(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const unsigned int threshold) const
+{
+	return (this->pimpl->meetsQualityThreshold(rawImage, threshold));
+}
+
+std::vector<NFIQ2::UnifiedQualityScoreResult>
+NFIQ2::Algorithm::computeUnifiedQualityScores(
+    const std::vector<NFIQ2::FingerprintImageData> &rawImages,
+    const unsigned int threadCount) const
+{
+	return (this->computeUnifiedQualityScores(rawImages, threadCount,
+	    NFIQ2::QualityMeasures::ComputationOptions {}));
+}
+
+std::vector<NFIQ2::UnifiedQualityScoreResult>
+NFIQ2::Algorithm::computeUnifiedQualityScores(
+    const std::vector<NFIQ2::FingerprintImageData> &rawImages,
+    const unsigned int threadCount,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	// views of the images, without copying pixels
+	const std::vector<NFIQ2::FingerprintImageView> views(
+	    rawImages.cbegin(), rawImages.cend());
+	return (this->pimpl->computeUnifiedQualityScores(views,
+	    threadCount, options));
+}
+
+std::vector<NFIQ2::UnifiedQualityScoreResult>
+NFIQ2::Algorithm::computeUnifiedQualityScores(
+    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+    const unsigned int threadCount) const
+{
+	return (this->pimpl->computeUnifiedQualityScores(rawImages,
+	    threadCount, NFIQ2::QualityMeasures::ComputationOptions {}));
+}
+
+std::vector<NFIQ2::UnifiedQualityScoreResult>
+NFIQ2::Algorithm::computeUnifiedQualityScores(
+    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+    const unsigned int threadCount,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	return (this->pimpl->computeUnifiedQualityScores(rawImages,
+	    threadCount, options));
+}
+
+std::vector<std::string>
+NFIQ2::Algorithm::getUnifiedQualityScoreFeatureOrder()
+{
+	return (Impl::getUnifiedQualityScoreFeatureOrder());
+}
+
+std::vector<unsigned int>
+NFIQ2::Algorithm::computeUnifiedQualityScores(
+    const std::vector<double> &features, const unsigned int threadCount) const
+{
+	return (this->pimpl->computeUnifiedQualityScores(
+	    features, threadCount));
+}
+
+std::future<unsigned int>
+NFIQ2::Algorithm::computeUnifiedQualityScoreAsync(
+    NFIQ2::FingerprintImageData rawImage) const
+{
+	return (this->pimpl->computeUnifiedQualityScoreAsync(
+	    std::move(rawImage),
+	    NFIQ2::QualityMeasures::ComputationOptions {}));
+}
+
+std::future<unsigned int>
+NFIQ2::Algorithm::computeUnifiedQualityScoreAsync(
+    NFIQ2::FingerprintImageData rawImage,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	return (this->pimpl->computeUnifiedQualityScoreAsync(
+	    std::move(rawImage), options));
+}
+
+void
+NFIQ2::Algorithm::setAsyncLimits(
+    const unsigned int threadCount, const size_t queueCapacity)
+{
+	Impl::setAsyncLimits(threadCount, queueCapacity);
+}
+
 std::unordered_map<std::string, unsigned int>
 NFIQ2::Algorithm::getQualityBlockValues(
     const std::unordered_map<std::string, double> &nativeQualityMeasureValues)
@@ -2,6 +2,7 @@
 #include <nfiq2_fingerprintimagedata.hpp>
 #include <nfiq2_qualitymeasures.hpp>
 #include <nfiq2_timer.hpp>
+#include <prediction/ModelRegistry.h>
 #include <quality_modules/FDA.h>
 #include <quality_modules/FJFXMinutiaeQuality.h>
 #include <quality_modules/FingerJetFX.h>
@@ -15,45 +16,67 @@
 #include <quality_modules/common_functions.h>
 
 #include "nfiq2_algorithm_impl.hpp"
+#include "nfiq2_parallel.hpp"
+#include "nfiq2_qualitymeasures_impl.hpp"
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
-NFIQ2::Algorithm::Impl::Impl()
-    : initialized { false }
+namespace {
+/**
+ * Start loading a model, waiting for it unless loading in the background.
+ *
+ * @throw NFIQ2::Exception
+ * Loading immediately failed.
+ */
+std::shared_future<NFIQ2::Prediction::ModelRegistry::Model>
+startLoading(const NFIQ2::Algorithm::ModelLoading loading,
+    const std::function<NFIQ2::Prediction::ModelRegistry::Model()> &load)
 {
-#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
-	// init RF module that takes some time to load the parameters
-	this->m_parameterHash = m_RandomForestML.initModule();
-	this->initialized = true;
-#endif
+	if (loading == NFIQ2::Algorithm::ModelLoading::Background) {
+		return std::async(std::launch::async, load).share();
+	}
+
+	std::promise<NFIQ2::Prediction::ModelRegistry::Model> model {};
+	model.set_value(load());
+	return model.get_future().share();
 }
 
-NFIQ2::Algorithm::Impl::Impl(const std::string &fileName,
-    const std::string &fileHash)
-    : initialized { false }
+/**
+ * Load the model of a file.
+ *
+ * @throw NFIQ2::Exception
+ * The model could not be loaded, with a description of the likely cause.
+ */
+NFIQ2::Prediction::ModelRegistry::Model
+loadModel(const std::string &fileName, const std::string &fileHash)
 {
-#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
-	throw Exception { NFIQ2::ErrorCode::BadArguments,
-		"Refusing to initialize random forest parameters with external "
-		"file because the NFIQ 2 library was built with embedded "
-		"random forest parameters." };
-#endif
-
-	// init RF module that takes some time to load the parameters
 	try {
-		this->m_parameterHash = m_RandomForestML.initModule(fileName,
-		    fileHash);
-		this->initialized = true;
+		return NFIQ2::Prediction::ModelRegistry::get(
+		    fileName, fileHash);
 	} catch (const cv::Exception &e) {
-		throw Exception(NFIQ2::ErrorCode::BadArguments,
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
 		    "Could not initialize random forest parameters with "
 		    "external file. Most likely, the file does not exist. "
 		    "Check the path (" +
 			fileName + ") and hash (" + fileHash +
 			") (initial error: " + e.msg + ").");
 	} catch (const NFIQ2::Exception &e) {
-		throw Exception(NFIQ2::ErrorCode::BadArguments,
+		if (e.getErrorCode() == NFIQ2::ErrorCode::CannotReadFromFile) {
+			throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+			    "Could not initialize random forest parameters "
+			    "with external file. Check the path (" +
+				fileName + ") (initial error: " + e.what() +
+				").");
+		}
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
 		    "Could not initialize random forest parameters with "
 		    "external file. Most likely, the hash is not correct. "
 		    "Check the path (" +
@@ -61,17 +84,45 @@ NFIQ2::Algorithm::Impl::Impl(const std::string &fileName,
 			") (initial error: " + e.what() + ").");
 	}
 }
+}
+
+NFIQ2::Algorithm::Impl::Impl(const ModelLoading loading)
+{
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
+	// init RF module that takes some time to load the parameters, once
+	// per process
+	this->m_model = startLoading(loading,
+	    &Prediction::ModelRegistry::getEmbedded);
+#else
+	static_cast<void>(loading);
+#endif
+}
+
+NFIQ2::Algorithm::Impl::Impl(const std::string &fileName,
+    const std::string &fileHash, const ModelLoading loading)
+{
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
+	throw Exception { NFIQ2::ErrorCode::BadArguments,
+		"Refusing to initialize random forest parameters with external "
+		"file because the NFIQ 2 library was built with embedded "
+		"random forest parameters." };
+#endif
+
+	// init RF module that takes some time to load the parameters
+	this->m_model = startLoading(loading,
+	    [fileName, fileHash]() { return loadModel(fileName, fileHash); });
+}
 
 #ifdef __ANDROID__
 NFIQ2::Algorithm::Impl::Impl(AAssetManager *assets, const std::string &fileName,
     const std::string &fileHash)
-    : initialized { false }
 {
 	// init RF module that takes some time to load the parameters
 	try {
-		this->m_parameterHash = m_RandomForestML.initModule(assets,
-		    fileName, fileHash);
-		this->initialized = true;
+		this->m_model = startLoading(ModelLoading::Immediate, [&]() {
+			return Prediction::ModelRegistry::get(assets, fileName,
+			    fileHash);
+		});
 	} catch (const cv::Exception &e) {
 		throw Exception(NFIQ2::ErrorCode::BadArguments,
 		    "Could not initialize random forest parameters with "
@@ -95,11 +146,43 @@ NFIQ2::Algorithm::Impl::~Impl() = default;
 double
 NFIQ2::Algorithm::Impl::getQualityPrediction(
     const std::unordered_map<std::string, double> &features) const
+{
+	return this->getQualityPrediction(
+	    NFIQ2::QualityMeasures::NativeQualityMeasureVector::fromMap(
+		features));
+}
+
+namespace {
+/**
+ * @throw NFIQ2::Exception
+ * A native quality measure the random forest needs is missing.
+ */
+void
+throwIfIncomplete(
+    const NFIQ2::QualityMeasures::NativeQualityMeasureVector &features)
+{
+	const unsigned int missing { features.firstMissing() };
+	if (missing !=
+	    NFIQ2::QualityMeasures::NativeQualityMeasureIndex::Count) {
+		throw NFIQ2::Exception(
+		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
+		    "Missing native quality measure " +
+			std::string(NFIQ2::QualityMeasures::
+				NativeQualityMeasureVector::getIdentifier(
+				    missing)));
+	}
+}
+}
+
+double
+NFIQ2::Algorithm::Impl::getQualityPrediction(
+    const NFIQ2::QualityMeasures::NativeQualityMeasureVector &features) const
 {
 	this->throwIfUninitialized();
+	throwIfIncomplete(features);
 
 	double quality {};
-	m_RandomForestML.evaluate(features, quality);
+	this->getModel().forest->evaluate(features.data(), 1, &quality);
 
 	return quality;
 }
@@ -111,10 +194,11 @@ NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
 {
 	this->throwIfUninitialized();
 
-	const std::unordered_map<std::string, double> quality =
-	    NFIQ2::QualityMeasures::getNativeQualityMeasures(features);
+	const NFIQ2::QualityMeasures::NativeQualityMeasureVector quality =
+	    NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureVector(
+		features);
 
-	if (quality.size() == 0) {
+	if (quality.empty()) {
 		// no features have been computed
 		throw NFIQ2::Exception(
 		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
@@ -137,7 +221,16 @@ NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
 
 unsigned int
 NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
-    const NFIQ2::FingerprintImageData &rawImage) const
+    const NFIQ2::FingerprintImageView &rawImage) const
+{
+	return this->computeUnifiedQualityScore(
+	    rawImage, NFIQ2::QualityMeasures::ComputationOptions {});
+}
+
+unsigned int
+NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
 {
 	this->throwIfUninitialized();
 
@@ -145,11 +238,33 @@ NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
 	// compute quality features (including actionable feedback)
 	// --------------------------------------------------------
 
+	const NFIQ2::QualityMeasures::NativeQualityMeasureVector quality =
+	    computeNativeQualityMeasures(rawImage, options);
+
+	// ---------------------
+	// compute quality score
+	// ---------------------
+
+	double qualityScore {};
+	try {
+		qualityScore = getQualityPrediction(quality);
+	} catch (const NFIQ2::Exception &) {
+		throw;
+	}
+
+	return (unsigned int)qualityScore;
+}
+
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
+NFIQ2::Algorithm::Impl::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const NFIQ2::QualityMeasures::ComputationOptions &options)
+{
 	std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	    modules {};
 	try {
 		modules = NFIQ2::QualityMeasures::
-		    computeNativeQualityMeasureAlgorithms(rawImage);
+		    computeNativeQualityMeasureAlgorithms(rawImage, options);
 	} catch (const NFIQ2::Exception &) {
 		throw;
 	} catch (const std::exception &e) {
@@ -162,28 +277,18 @@ NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
 		    e.what());
 	}
 
-	const std::unordered_map<std::string, double> quality =
-	    NFIQ2::QualityMeasures::getNativeQualityMeasures(modules);
+	const NFIQ2::QualityMeasures::NativeQualityMeasureVector quality =
+	    NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureVector(
+		modules);
 
-	if (quality.size() == 0) {
+	if (quality.empty()) {
 		// no features have been computed
 		throw NFIQ2::Exception(
 		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
 		    "No features have been computed");
 	}
 
-	// ---------------------
-	// compute quality score
-	// ---------------------
-
-	double qualityScore {};
-	try {
-		qualityScore = getQualityPrediction(quality);
-	} catch (const NFIQ2::Exception &) {
-		throw;
-	}
-
-	return (unsigned int)qualityScore;
+	return quality;
 }
 
 unsigned int
@@ -195,6 +300,200 @@ NFIQ2::Algorithm::Impl::computeUnifiedQualityScore(
 	return (unsigned int)getQualityPrediction(features);
 }
 
+NFIQ2::QualityThresholdResult
+NFIQ2::Algorithm::Impl::meetsQualityThreshold(
+    const std::unordered_map<std::string, double> &features,
+    const unsigned int threshold) const
+{
+	return this->meetsQualityThreshold(
+	    NFIQ2::QualityMeasures::NativeQualityMeasureVector::fromMap(
+		features),
+	    threshold);
+}
+
+NFIQ2::QualityThresholdResult
+NFIQ2::Algorithm::Impl::meetsQualityThreshold(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const unsigned int threshold) const
+{
+	this->throwIfUninitialized();
+
+	return this->meetsQualityThreshold(
+	    computeNativeQualityMeasures(
+		rawImage, NFIQ2::QualityMeasures::ComputationOptions {}),
+	    threshold);
+}
+
+NFIQ2::QualityThresholdResult
+NFIQ2::Algorithm::Impl::meetsQualityThreshold(
+    const NFIQ2::QualityMeasures::NativeQualityMeasureVector &features,
+    const unsigned int threshold) const
+{
+	this->throwIfUninitialized();
+	throwIfIncomplete(features);
+
+	return this->getModel().forest->meetsQualityThreshold(
+	    features.data(), threshold);
+}
+
+std::vector<NFIQ2::UnifiedQualityScoreResult>
+NFIQ2::Algorithm::Impl::computeUnifiedQualityScores(
+    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+    const unsigned int threadCount,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	this->throwIfUninitialized();
+
+	std::vector<UnifiedQualityScoreResult> results(rawImages.size());
+	NFIQ2::QualityMeasures::Impl::parallelFor(rawImages.size(),
+	    threadCount, options.executor, [&](size_t i) {
+		    UnifiedQualityScoreResult &result = results[i];
+		    try {
+			    result.unifiedQualityScore =
+				this->computeUnifiedQualityScore(
+				    rawImages[i], options);
+			    result.success = true;
+		    } catch (const NFIQ2::Exception &e) {
+			    result.errorCode = e.getErrorCode();
+			    result.errorMessage = e.getErrorMessage();
+		    } catch (const std::exception &e) {
+			    result.errorCode = NFIQ2::ErrorCode::UnknownError;
+			    result.errorMessage = e.what();
+		    } catch (...) {
+			    result.errorCode = NFIQ2::ErrorCode::UnknownError;
+			    result.errorMessage =
+				NFIQ2::Exception::defaultErrorMessage(
+				    NFIQ2::ErrorCode::UnknownError);
+		    }
+	    });
+
+	// native quality measures were computed while loading in the
+	// background; a loading error is thrown, not reported per image
+	this->getModel();
+
+	return results;
+}
+
+std::vector<std::string>
+NFIQ2::Algorithm::Impl::getUnifiedQualityScoreFeatureOrder()
+{
+	const auto &featureOrder =
+	    NFIQ2::Prediction::RandomForestML::getFeatureOrder();
+	return std::vector<std::string>(
+	    featureOrder.cbegin(), featureOrder.cend());
+}
+
+std::vector<unsigned int>
+NFIQ2::Algorithm::Impl::computeUnifiedQualityScores(
+    const std::vector<double> &features, const unsigned int threadCount) const
+{
+	this->throwIfUninitialized();
+
+	static const size_t featureCount {
+		NFIQ2::Prediction::RandomForestML::FeatureCount
+	};
+	if ((features.size() % featureCount) != 0) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+		    "Number of native quality measures (" +
+			std::to_string(features.size()) +
+			") is not a multiple of " +
+			std::to_string(featureCount));
+	}
+
+	/* Large enough to amortize scheduling, small enough to balance */
+	static const size_t chunkSize { 4096 };
+	const size_t sampleCount { features.size() / featureCount };
+	const size_t chunkCount { (sampleCount + chunkSize - 1) / chunkSize };
+
+	const NFIQ2::Prediction::RandomForestML &forest =
+	    *this->getModel().forest;
+	std::vector<double> qualities(sampleCount);
+	NFIQ2::QualityMeasures::Impl::parallelFor(chunkCount, threadCount,
+	    NFIQ2::QualityMeasures::Executor {}, [&](size_t chunk) {
+		    const size_t first { chunk * chunkSize };
+		    forest.evaluate(
+			features.data() + (first * featureCount),
+			std::min(chunkSize, sampleCount - first),
+			qualities.data() + first);
+	    });
+
+	return std::vector<unsigned int>(qualities.cbegin(), qualities.cend());
+}
+
+namespace {
+/** Limits and executor of asynchronous unified quality score computations */
+struct AsyncState {
+	std::mutex mutex {};
+	unsigned int threadCount { 0 };
+	size_t queueCapacity { 0 };
+	std::shared_ptr<NFIQ2::QualityMeasures::Impl::BoundedExecutor>
+	    executor {};
+};
+
+AsyncState &
+getAsyncState()
+{
+	static AsyncState state {};
+	return state;
+}
+
+std::shared_ptr<NFIQ2::QualityMeasures::Impl::BoundedExecutor>
+getAsyncExecutor()
+{
+	AsyncState &state = getAsyncState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!state.executor) {
+		state.executor = std::make_shared<
+		    NFIQ2::QualityMeasures::Impl::BoundedExecutor>(
+		    state.threadCount, state.queueCapacity);
+	}
+
+	return state.executor;
+}
+}
+
+std::future<unsigned int>
+NFIQ2::Algorithm::Impl::computeUnifiedQualityScoreAsync(
+    NFIQ2::FingerprintImageData rawImage,
+    const NFIQ2::QualityMeasures::ComputationOptions &options) const
+{
+	this->throwIfUninitialized();
+
+	/* Computation must not depend on this object living on */
+	const auto impl = std::make_shared<const Impl>(*this);
+	const auto image = std::make_shared<const FingerprintImageData>(
+	    std::move(rawImage));
+	const auto task =
+	    std::make_shared<std::packaged_task<unsigned int()>>(
+		[impl, image, options]() {
+			return impl->computeUnifiedQualityScore(
+			    *image, options);
+		});
+
+	std::future<unsigned int> score = task->get_future();
+	getAsyncExecutor()->submit([task]() { (*task)(); });
+
+	return score;
+}
+
+void
+NFIQ2::Algorithm::Impl::setAsyncLimits(
+    const unsigned int threadCount, const size_t queueCapacity)
+{
+	std::shared_ptr<NFIQ2::QualityMeasures::Impl::BoundedExecutor>
+	    previous {};
+	{
+		AsyncState &state = getAsyncState();
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.threadCount = threadCount;
+		state.queueCapacity = queueCapacity;
+		previous = std::move(state.executor);
+	}
+
+	/* Queued computations complete when the last user lets go */
+	previous.reset();
+}
+
 std::unordered_map<std::string, unsigned int>
 NFIQ2::Algorithm::Impl::getQualityBlockValues(
     const std::unordered_map<std::string, double> &nativeQualityMeasureValues)
@@ -219,23 +518,40 @@ NFIQ2::Algorithm::Impl::getQualityBlockValue(
 std::string
 NFIQ2::Algorithm::Impl::getParameterHash() const
 {
-	this->throwIfUninitialized();
-
-	return (this->m_parameterHash);
+	return (this->getModel().parameterHash);
 }
 
 void
 NFIQ2::Algorithm::Impl::throwIfUninitialized() const
 {
-	if (!this->isInitialized())
+	if (!this->m_model.valid())
 		throw NFIQ2::Exception { NFIQ2::ErrorCode::MachineLearningError,
 			"Random forest parameters were not loaded" };
 }
 
+const NFIQ2::Prediction::ModelRegistry::Model &
+NFIQ2::Algorithm::Impl::getModel() const
+{
+	this->throwIfUninitialized();
+
+	// waits for parameters loading in the background, rethrowing
+	// loading errors
+	return (this->m_model.get());
+}
+
 bool
 NFIQ2::Algorithm::Impl::isInitialized() const
 {
-	return (this->initialized);
+	if (!this->m_model.valid()) {
+		return (false);
+	}
+
+	try {
+		this->m_model.get();
+	} catch (const std::exception &) {
+		return (false);
+	}
+	return (true);
 }
 
 bool
@@ -5,10 +5,15 @@
 #include <nfiq2_constants.hpp>
 #include <nfiq2_exception.hpp>
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+#include <prediction/ModelRegistry.h>
 #include <prediction/RandomForestML.h>
+#include <quality_modules/NativeQualityMeasures.h>
 
 #include <fstream>
+#include <future>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,11 +26,14 @@ class Algorithm::Impl {
 	 * @brief
 	 * Default constructor of Algorithm.
 	 *
+	 * @param loading
+	 * When to load the random forest parameters.
+	 *
 	 * @note
 	 * May load from parameters compiled into source code, in which case
 	 * this can be slow.
 	 */
-	Impl();
+	Impl(const ModelLoading loading);
 
 	/**
 	 * @brief
@@ -35,8 +43,11 @@ class Algorithm::Impl {
 	 * The file path containing the random forest model.
 	 * @param fileHash
 	 * The md5 checksum of the provided file.
+	 * @param loading
+	 * When to load the random forest parameters.
 	 */
-	Impl(const std::string &fileName, const std::string &fileHash);
+	Impl(const std::string &fileName, const std::string &fileHash,
+	    const ModelLoading loading);
 
 #ifdef __ANDROID__
 	/**
@@ -58,7 +69,11 @@ class Algorithm::Impl {
 	virtual ~Impl();
 
 	unsigned int computeUnifiedQualityScore(
-	    const NFIQ2::FingerprintImageData &rawImage) const;
+	    const NFIQ2::FingerprintImageView &rawImage) const;
+
+	unsigned int computeUnifiedQualityScore(
+	    const NFIQ2::FingerprintImageView &rawImage,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
 
 	unsigned int computeUnifiedQualityScore(const std::vector<
 	    std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>> &algorithms)
@@ -75,6 +90,32 @@ class Algorithm::Impl {
 	unsigned int computeUnifiedQualityScore(
 	    const std::unordered_map<std::string, double> &algorithms) const;
 
+	QualityThresholdResult meetsQualityThreshold(
+	    const std::unordered_map<std::string, double> &features,
+	    const unsigned int threshold) const;
+
+	QualityThresholdResult meetsQualityThreshold(
+	    const NFIQ2::FingerprintImageView &rawImage,
+	    const unsigned int threshold) const;
+
+	std::vector<UnifiedQualityScoreResult> computeUnifiedQualityScores(
+	    const std::vector<NFIQ2::FingerprintImageView> &rawImages,
+	    const unsigned int threadCount,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
+
+	static std::vector<std::string> getUnifiedQualityScoreFeatureOrder();
+
+	std::vector<unsigned int> computeUnifiedQualityScores(
+	    const std::vector<double> &features,
+	    const unsigned int threadCount) const;
+
+	std::future<unsigned int> computeUnifiedQualityScoreAsync(
+	    NFIQ2::FingerprintImageData rawImage,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options) const;
+
+	static void setAsyncLimits(
+	    const unsigned int threadCount, const size_t queueCapacity);
+
 	std::string getParameterHash() const;
 
 	bool isEmbedded() const;
@@ -84,8 +125,12 @@ class Algorithm::Impl {
 	unsigned int getEmbeddedFCT() const;
 
     private:
-	/** Indicates whether random forest parameters have been loaded. */
-	bool initialized { false };
+	/**
+	 * Random forest parameters, loading or loaded, shared with every Impl
+	 * using the same parameters. Not valid if no parameters were
+	 * requested.
+	 */
+	std::shared_future<Prediction::ModelRegistry::Model> m_model {};
 
 	/**
 	 * @brief
@@ -107,21 +152,73 @@ class Algorithm::Impl {
 	    const std::unordered_map<std::string, double>
 		&nativeQualityMeasureValues) const;
 
+	/**
+	 * @brief
+	 * Retrieves unified quality score from native quality measures laid
+	 * out in random forest order.
+	 *
+	 * @param nativeQualityMeasures
+	 * Native quality measures, all of which must be set.
+	 *
+	 * @return
+	 * Computed unified quality score.
+	 *
+	 * @throws Exception
+	 * A native quality measure is missing, failure to compute, or
+	 * called before random forest parameters loaded.
+	 */
+	double getQualityPrediction(
+	    const NFIQ2::QualityMeasures::NativeQualityMeasureVector
+		&nativeQualityMeasures) const;
+
+	/**
+	 * @brief
+	 * Decide whether the unified quality score of native quality measures
+	 * laid out in random forest order is at least `threshold`.
+	 *
+	 * @throws Exception
+	 * A native quality measure is missing, failure to compute, or
+	 * called before random forest parameters loaded.
+	 */
+	QualityThresholdResult meetsQualityThreshold(
+	    const NFIQ2::QualityMeasures::NativeQualityMeasureVector
+		&nativeQualityMeasures,
+	    const unsigned int threshold) const;
+
+	/**
+	 * @brief
+	 * Compute the native quality measures of an image.
+	 *
+	 * @throws Exception
+	 * Native quality measures could not be computed.
+	 */
+	static NFIQ2::QualityMeasures::NativeQualityMeasureVector
+	computeNativeQualityMeasures(
+	    const NFIQ2::FingerprintImageView &rawImage,
+	    const NFIQ2::QualityMeasures::ComputationOptions &options);
+
 	/**
 	 * @brief
 	 * Throw an exception if random forest parameters have not been
-	 * loaded.
+	 * requested.
 	 *
 	 * @throw NFIQ2::Exception
-	 * Random forest parameters have not been loaded.
+	 * Random forest parameters have not been requested.
+	 *
+	 * @note
+	 * Does not wait for parameters loading in the background, so that
+	 * native quality measures can be computed in the meantime.
 	 */
 	void throwIfUninitialized() const;
 
-	/** RandomForest parameters. */
-	NFIQ2::Prediction::RandomForestML m_RandomForestML;
-
-	/** RandomForest parameter md5 hash. */
-	std::string m_parameterHash {};
+	/**
+	 * @brief
+	 * Obtain the random forest parameters, waiting for them to load.
+	 *
+	 * @throw NFIQ2::Exception
+	 * Random forest parameters were not requested or could not be loaded.
+	 */
+	const Prediction::ModelRegistry::Model &getModel() const;
 };
 } // namespace NFIQ2
 
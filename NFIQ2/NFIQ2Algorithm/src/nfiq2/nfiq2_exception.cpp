@@ -64,7 +64,9 @@ NFIQ2::Exception::defaultErrorMessage(const NFIQ2::ErrorCode errorCode)
 		    "No feature set could be created" },
 		{ NFIQ2::ErrorCode::InvalidUnifiedQualityScore,
 		    "Invalid NFIQ2 Score" },
-		{ NFIQ2::ErrorCode::InvalidImageSize, "Invalid Image Size" }
+		{ NFIQ2::ErrorCode::InvalidImageSize, "Invalid Image Size" },
+		{ NFIQ2::ErrorCode::UniformOrEmptyImage,
+		    "Image is uniform or empty" }
 	};
 
 	const auto message = errorCodeMessage.find(errorCode);
@@ -0,0 +1,200 @@
+#include <nfiq2_exception.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
+
+#include <string>
+#include <vector>
+
+NFIQ2::FingerprintImageView::FingerprintImageView(const uint8_t *pixels_,
+    uint32_t width_, uint32_t height_, uint32_t stride_, uint8_t fingerCode_,
+    uint16_t ppi_)
+    : pixels(pixels_)
+    , width(width_)
+    , height(height_)
+    , stride(stride_)
+    , fingerCode(fingerCode_)
+    , ppi(ppi_)
+{
+	if (this->stride < this->width) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+		    "Stride (" + std::to_string(this->stride) +
+			") is less than width (" + std::to_string(this->width) +
+			')');
+	}
+	if ((this->pixels == nullptr) && (this->width != 0) &&
+	    (this->height != 0)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+		    "No pixels for a non-empty image");
+	}
+}
+
+NFIQ2::FingerprintImageView::FingerprintImageView(
+    const NFIQ2::FingerprintImageData &image)
+    : pixels(image.data())
+    , width(image.width)
+    , height(image.height)
+    , stride(image.width)
+    , fingerCode(image.fingerCode)
+    , ppi(image.ppi)
+{
+}
+
+NFIQ2::FingerprintImageView
+NFIQ2::FingerprintImageView::viewRemovingNearWhiteFrame() const
+{
+	/**
+	 * Pixel intensity threshold used for determining whitespace
+	 * around fingerprint. Consecutive rows <= this value starting on each
+	 * edge shall be removed.
+	 */
+	static const double MU_THRESHOLD { 250 };
+
+	const int rows = static_cast<int>(this->height);
+	const int cols = static_cast<int>(this->width);
+
+	// Sum every row and every column in a single pass over the image, in
+	// memory order. Column sums are accumulated a whole row at a time so
+	// that no pass strides down the image.
+	std::vector<uint32_t> rowSums(static_cast<size_t>(rows));
+	std::vector<uint32_t> columnSums(static_cast<size_t>(cols));
+	for (int i = 0; i < rows; ++i) {
+		const uint8_t *row = this->pixels +
+		    (static_cast<size_t>(i) * this->stride);
+		uint32_t *columnSum = columnSums.data();
+		uint32_t rowSum { 0 };
+		for (int j = 0; j < cols; ++j) {
+			rowSum += row[j];
+			columnSum[j] += row[j];
+		}
+		rowSums[static_cast<size_t>(i)] = rowSum;
+	}
+
+	// Means are computed exactly as when scanning each row and column
+	// separately, so the crop does not change.
+	const auto rowMu = [&](const int rowIndex) {
+		return static_cast<double>(
+		    rowSums[static_cast<size_t>(rowIndex)]) /
+		    static_cast<double>(cols);
+	};
+	const auto columnMu = [&](const int columnIndex) {
+		return static_cast<double>(
+		    columnSums[static_cast<size_t>(columnIndex)]) /
+		    static_cast<double>(rows);
+	};
+
+	// start from top of image and find top row index that is already part
+	// of the fingerprint image
+	int topRowIndex { 0 }, bottomRowIndex { rows - 1 };
+	for (; topRowIndex < rows; ++topRowIndex) {
+		if (rowMu(topRowIndex) <= MU_THRESHOLD) {
+			break;
+		}
+	}
+
+	// If we traversed all rows and never found data, we can stop
+	if (topRowIndex >= rows) {
+		throw NFIQ2::Exception { NFIQ2::ErrorCode::InvalidImageSize,
+			"All image rows appear to be blank" };
+	} else {
+		// start from bottom of image and find bottom row index that is
+		// already part of the fingerprint image
+		for (; bottomRowIndex >= topRowIndex; --bottomRowIndex) {
+			if (rowMu(bottomRowIndex) <= MU_THRESHOLD) {
+				break;
+			}
+		}
+
+		// topRowIndex was 0 and was the only row with pixels. for loop
+		// made us go negative.
+		if (bottomRowIndex <= 0)
+			bottomRowIndex = 0;
+	}
+
+	// start from left of image and find left index that is already part of
+	// the fingerprint image
+	int leftIndex { 0 }, rightIndex { cols - 1 };
+	for (; leftIndex < cols; ++leftIndex) {
+		if (columnMu(leftIndex) <= MU_THRESHOLD) {
+			break;
+		}
+	}
+
+	// If we traversed all the columns, then we don't need to check starting
+	// from the other side.
+	if (leftIndex >= cols) {
+		// If we traversed all columns and never found data, we can stop
+		throw NFIQ2::Exception { NFIQ2::ErrorCode::InvalidImageSize,
+			"All image columns appear to be blank" };
+	} else {
+		// start from right of image and find right index that is
+		// already part of the fingerprint image
+		for (; rightIndex >= leftIndex; --rightIndex) {
+			if (columnMu(rightIndex) <= MU_THRESHOLD) {
+				break;
+			}
+		}
+		// leftRow was 0 and was the only column with pixels. for loop
+		// made us go negative.
+		if (rightIndex <= 0)
+			rightIndex = 0;
+	}
+	if ((rightIndex <= leftIndex) || (bottomRowIndex <= topRowIndex))
+		throw NFIQ2::Exception { NFIQ2::ErrorCode::InvalidImageSize,
+			"Asked to inclusively crop from (" +
+			    std::to_string(leftIndex) + ',' +
+			    std::to_string(topRowIndex) + ") to (" +
+			    std::to_string(rightIndex) + ',' +
+			    std::to_string(bottomRowIndex) + ')' };
+
+	// Bounds are inclusive
+	const int croppedWidth = rightIndex - leftIndex + 1;
+	const int croppedHeight = bottomRowIndex - topRowIndex + 1;
+
+	static const uint16_t fingerJetMaxWidth = 800;
+	static const uint16_t fingerJetMaxHeight = 1000;
+
+	// Values are from FJFX image size thresholds
+	if (croppedWidth > fingerJetMaxWidth) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidImageSize,
+		    "Width is too large after trimming whitespace. WxH: " +
+			std::to_string(croppedWidth) + "x" +
+			std::to_string(croppedHeight) +
+			", but maximum width is " +
+			std::to_string(fingerJetMaxWidth));
+	} else if (croppedHeight > fingerJetMaxHeight) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidImageSize,
+		    "Height is too large after trimming whitespace. WxH: " +
+			std::to_string(croppedWidth) + "x" +
+			std::to_string(croppedHeight) +
+			", but maximum height is " +
+			std::to_string(fingerJetMaxHeight));
+	}
+
+	return NFIQ2::FingerprintImageView(this->pixels +
+		(static_cast<size_t>(topRowIndex) * this->stride) + leftIndex,
+	    static_cast<uint32_t>(croppedWidth),
+	    static_cast<uint32_t>(croppedHeight), this->stride,
+	    this->fingerCode, this->ppi);
+}
+
+NFIQ2::FingerprintImageData
+NFIQ2::FingerprintImageView::copyRemovingNearWhiteFrame() const
+{
+	const NFIQ2::FingerprintImageView cropped =
+	    this->viewRemovingNearWhiteFrame();
+
+	NFIQ2::FingerprintImageData croppedImage;
+	croppedImage.height = cropped.height;
+	croppedImage.width = cropped.width;
+	croppedImage.fingerCode = cropped.fingerCode;
+	croppedImage.ppi = cropped.ppi;
+	// copy data now
+	croppedImage.reserve(
+	    static_cast<size_t>(cropped.width) * cropped.height);
+	for (uint32_t i = 0; i < cropped.height; i++) {
+		croppedImage.append(cropped.pixels +
+			(static_cast<size_t>(i) * cropped.stride),
+		    cropped.width);
+	}
+
+	return croppedImage;
+}
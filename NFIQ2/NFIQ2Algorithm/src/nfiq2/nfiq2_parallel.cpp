@@ -0,0 +1,206 @@
+#include "nfiq2_parallel.hpp"
+#include "nfiq2_qualitymeasures_impl.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Work shared between the threads of one parallelFor() call */
+struct ParallelForState {
+	ParallelForState(const size_t count,
+	    const std::function<void(size_t)> &task)
+	    : count { count }
+	    , task { task }
+	    , exceptions(count)
+	{
+	}
+
+	const size_t count;
+	/** Only invoked for claimed indices, which the caller waits on */
+	const std::function<void(size_t)> &task;
+
+	std::atomic<size_t> next { 0 };
+	std::atomic<bool> failed { false };
+	std::vector<std::exception_ptr> exceptions;
+
+	std::mutex mutex {};
+	std::condition_variable finished {};
+	size_t completed { 0 };
+};
+
+void
+work(ParallelForState &state)
+{
+	for (;;) {
+		const size_t index = state.next++;
+		if (index >= state.count) {
+			return;
+		}
+
+		if (!state.failed) {
+			try {
+				state.task(index);
+			} catch (...) {
+				state.exceptions[index] =
+				    std::current_exception();
+				state.failed = true;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(state.mutex);
+		if (++state.completed == state.count) {
+			state.finished.notify_all();
+		}
+	}
+}
+}
+
+unsigned int
+NFIQ2::QualityMeasures::Impl::resolveThreadCount(
+    const unsigned int threadCount)
+{
+	if (threadCount != 0) {
+		return threadCount;
+	}
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void
+NFIQ2::QualityMeasures::Impl::parallelFor(const size_t count,
+    const unsigned int threadCount, const Executor &executor,
+    const std::function<void(size_t)> &task)
+{
+	if (count == 0) {
+		return;
+	}
+
+	const size_t helperCount = std::min<size_t>(
+				       resolveThreadCount(threadCount), count) -
+	    1;
+	if (helperCount == 0) {
+		for (size_t i = 0; i < count; i++) {
+			task(i);
+		}
+		return;
+	}
+
+	const auto state = std::make_shared<ParallelForState>(count, task);
+	const auto helper = [state]() {
+		/* use double-precision rounding for 32-bit linux */
+		setFPU(0x27F);
+		work(*state);
+	};
+
+	std::vector<std::thread> threads {};
+	for (size_t i = 0; i < helperCount; i++) {
+		try {
+			if (executor) {
+				executor(helper);
+			} else {
+				threads.emplace_back(helper);
+			}
+		} catch (...) {
+			/* Fewer helpers, the calling thread still works */
+			break;
+		}
+	}
+
+	work(*state);
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(
+		    lock, [&state]() { return state->completed == state->count; });
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	for (const auto &exception : state->exceptions) {
+		if (exception) {
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+NFIQ2::QualityMeasures::Impl::BoundedExecutor::BoundedExecutor(
+    const unsigned int threadCount, const size_t queueCapacity)
+{
+	const unsigned int resolvedThreadCount = resolveThreadCount(
+	    threadCount);
+	this->queueCapacity_ = (queueCapacity != 0) ?
+	    queueCapacity :
+	    (2 * static_cast<size_t>(resolvedThreadCount));
+
+	try {
+		for (unsigned int i = 0; i < resolvedThreadCount; i++) {
+			this->threads_.emplace_back([this]() {
+				/* use double-precision rounding for 32-bit
+				 * linux */
+				setFPU(0x27F);
+				this->work();
+			});
+		}
+	} catch (...) {
+		if (this->threads_.empty()) {
+			throw;
+		}
+		/* Run with the threads that could be started */
+	}
+}
+
+NFIQ2::QualityMeasures::Impl::BoundedExecutor::~BoundedExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->stopping_ = true;
+	}
+	this->notEmpty_.notify_all();
+
+	for (auto &thread : this->threads_) {
+		thread.join();
+	}
+}
+
+void
+NFIQ2::QualityMeasures::Impl::BoundedExecutor::submit(
+    std::function<void()> task)
+{
+	{
+		std::unique_lock<std::mutex> lock(this->mutex_);
+		this->notFull_.wait(lock, [this]() {
+			return this->queue_.size() < this->queueCapacity_;
+		});
+		this->queue_.push_back(std::move(task));
+	}
+	this->notEmpty_.notify_one();
+}
+
+void
+NFIQ2::QualityMeasures::Impl::BoundedExecutor::work()
+{
+	for (;;) {
+		std::function<void()> task {};
+		{
+			std::unique_lock<std::mutex> lock(this->mutex_);
+			this->notEmpty_.wait(lock, [this]() {
+				return this->stopping_ || !this->queue_.empty();
+			});
+			if (this->queue_.empty()) {
+				return;
+			}
+			task = std::move(this->queue_.front());
+			this->queue_.pop_front();
+		}
+		this->notFull_.notify_one();
+
+		task();
+	}
+}
@@ -0,0 +1,116 @@
+#ifndef NFIQ2_PARALLEL_HPP_
+#define NFIQ2_PARALLEL_HPP_
+
+#include <nfiq2_qualitymeasures.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NFIQ2 { namespace QualityMeasures { namespace Impl {
+
+/**
+ * @brief
+ * Obtain the number of threads to use for a requested thread count.
+ *
+ * @param threadCount
+ * Requested number of threads, 0 for one per hardware thread.
+ *
+ * @return
+ * `threadCount`, or the number of hardware threads (at least 1) when
+ * `threadCount` is 0.
+ */
+unsigned int resolveThreadCount(const unsigned int threadCount);
+
+/**
+ * @brief
+ * Run a task once for each index in [0, `count`), possibly concurrently.
+ *
+ * @details
+ * The calling thread takes part in the work, so this returns even if
+ * `executor` never runs the helper tasks it is given. Helpers set the
+ * same floating point mode as computeNativeQualityMeasureAlgorithms().
+ *
+ * Indices are started in increasing order. Once a task has thrown,
+ * indices not yet started are skipped.
+ *
+ * @param count
+ * Number of indices.
+ * @param threadCount
+ * Maximum number of threads running tasks, including the calling thread.
+ * 0 for one per hardware thread.
+ * @param executor
+ * Executor on which `threadCount` - 1 helper tasks are scheduled. When
+ * empty, helper threads are started and joined by this call.
+ * @param task
+ * Task to run for each index.
+ *
+ * @throw
+ * Exception thrown by `task` for the lowest index, rethrown once no task
+ * is running anymore.
+ */
+void parallelFor(const size_t count, const unsigned int threadCount,
+    const Executor &executor, const std::function<void(size_t)> &task);
+
+/**
+ * @brief
+ * Fixed set of threads running tasks from a bounded queue.
+ *
+ * @details
+ * Threads set the same floating point mode as
+ * computeNativeQualityMeasureAlgorithms() before running tasks.
+ */
+class BoundedExecutor {
+    public:
+	/**
+	 * @brief
+	 * Constructor.
+	 *
+	 * @param threadCount
+	 * Number of threads running tasks, 0 for one per hardware thread.
+	 * @param queueCapacity
+	 * Maximum number of tasks waiting for a thread, 0 for twice the
+	 * number of threads.
+	 */
+	BoundedExecutor(
+	    const unsigned int threadCount, const size_t queueCapacity);
+
+	/** Destructor. Runs all queued tasks, then stops the threads. */
+	~BoundedExecutor();
+
+	BoundedExecutor(const BoundedExecutor &) = delete;
+	BoundedExecutor &operator=(const BoundedExecutor &) = delete;
+
+	/**
+	 * @brief
+	 * Queue a task.
+	 *
+	 * @details
+	 * Blocks while the queue is full. Must not be called from a task
+	 * of the same executor, which could wait on itself.
+	 *
+	 * @param task
+	 * Task to run. Must not throw.
+	 */
+	void submit(std::function<void()> task);
+
+    private:
+	/** Run queued tasks until stopping and the queue is empty. */
+	void work();
+
+	size_t queueCapacity_ {};
+	std::mutex mutex_ {};
+	std::condition_variable notEmpty_ {};
+	std::condition_variable notFull_ {};
+	std::deque<std::function<void()>> queue_ {};
+	bool stopping_ { false };
+	std::vector<std::thread> threads_ {};
+};
+
+}}}
+
+#endif /* NFIQ2_PARALLEL_HPP_ */
@@ -25,12 +25,42 @@ NFIQ2::QualityMeasures::getNativeQualityMeasureAlgorithmIDs()
 
 std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
 	return NFIQ2::QualityMeasures::Impl::
 	    computeNativeQualityMeasureAlgorithms(rawImage);
 }
 
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::Impl::
+	    computeNativeQualityMeasureAlgorithms(rawImage, options);
+}
+
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs)
+{
+	return NFIQ2::QualityMeasures::Impl::
+	    computeNativeQualityMeasureAlgorithms(
+		rawImage, algorithmIDs, ComputationOptions {});
+}
+
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::Impl::
+	    computeNativeQualityMeasureAlgorithms(
+		rawImage, algorithmIDs, options);
+}
+
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::getActionableQualityFeedback(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
@@ -42,7 +72,7 @@ NFIQ2::QualityMeasures::getActionableQualityFeedback(
 
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::computeActionableQualityFeedback(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
 	return NFIQ2::QualityMeasures::Impl::computeActionableQualityFeedback(
 	    rawImage);
@@ -58,12 +88,40 @@ NFIQ2::QualityMeasures::getNativeQualityMeasures(
 
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::computeNativeQualityMeasures(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
 	return NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
 	    rawImage);
 }
 
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
+	    rawImage, options);
+}
+
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs)
+{
+	return NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
+	    rawImage, algorithmIDs, ComputationOptions {});
+}
+
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
+	    rawImage, algorithmIDs, options);
+}
+
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::getNativeQualityMeasureAlgorithmSpeeds(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
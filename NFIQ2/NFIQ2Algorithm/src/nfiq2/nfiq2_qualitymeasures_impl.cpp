@@ -3,6 +3,7 @@
 #include <nfiq2_qualitymeasures.hpp>
 #include <quality_modules/FDA.h>
 #include <quality_modules/FJFXMinutiaeQuality.h>
+#include <quality_modules/FeatureContext.h>
 #include <quality_modules/FingerJetFX.h>
 #include <quality_modules/ImgProcROI.h>
 #include <quality_modules/LCS.h>
@@ -13,12 +14,18 @@
 #include <quality_modules/QualityMap.h>
 #include <quality_modules/RVUPHistogram.h>
 
+#include "nfiq2_parallel.hpp"
 #include "nfiq2_qualitymeasures_impl.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
 #include <iomanip>
 #include <list>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 const char NFIQ2::Identifiers::ActionableQualityFeedback::
@@ -47,14 +54,10 @@ NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureAlgorithmSpeeds(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	&features)
 {
-	std::vector<std::string> speedIdentifiers =
-	    NFIQ2::QualityMeasures::getNativeQualityMeasureAlgorithmIDs();
-
 	std::unordered_map<std::string, double> speedMap {};
 
-	for (std::vector<std::string>::size_type i = 0;
-	     i < speedIdentifiers.size(); i++) {
-		speedMap[speedIdentifiers.at(i)] = features.at(i)->getSpeed();
+	for (const auto &feature : features) {
+		speedMap[feature->getName()] = feature->getSpeed();
 	}
 
 	return speedMap;
@@ -62,23 +65,51 @@ NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureAlgorithmSpeeds(
 
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
 	return NFIQ2::QualityMeasures::getNativeQualityMeasures(
 	    NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
 		rawImage));
 }
 
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::getNativeQualityMeasures(
+	    NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
+		rawImage, options));
+}
+
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options)
+{
+	return NFIQ2::QualityMeasures::getNativeQualityMeasures(
+	    NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
+		rawImage, algorithmIDs, options));
+}
+
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::Impl::getNativeQualityMeasures(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	&features)
 {
-	std::unordered_map<std::string, double> quality {};
+	return getNativeQualityMeasureVector(features).toMap();
+}
+
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
+NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureVector(
+    const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+	&features)
+{
+	NativeQualityMeasureVector quality {};
 
 	for (const auto &feature : features) {
-		const auto moduleFeatures = feature->getFeatures();
-		quality.insert(moduleFeatures.cbegin(), moduleFeatures.cend());
+		quality.merge(feature->getFeatureVector());
 	}
 
 	return quality;
@@ -86,11 +117,17 @@ NFIQ2::QualityMeasures::Impl::getNativeQualityMeasures(
 
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::Impl::computeActionableQualityFeedback(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
+	/* Only these algorithms contribute to actionable quality feedback */
 	return NFIQ2::QualityMeasures::getActionableQualityFeedback(
 	    NFIQ2::QualityMeasures::computeNativeQualityMeasureAlgorithms(
-		rawImage));
+		rawImage,
+		{ Identifiers::QualityMeasureAlgorithms::Contrast,
+		    Identifiers::QualityMeasureAlgorithms::MinutiaeCount,
+		    Identifiers::QualityMeasureAlgorithms::
+			RegionOfInterestMean },
+		ComputationOptions {}));
 }
 
 std::unordered_map<std::string, double>
@@ -128,25 +165,21 @@ NFIQ2::QualityMeasures::Impl::getActionableQualityFeedback(
 			// Mu is computed always since it is used as feature
 			// anyway
 			bool isEmptyImage = false;
-			for (const auto &muFeature :
-			    muFeatureModule->getFeatures()) {
-				if (muFeature.first ==
-				    Identifiers::QualityMeasures::Contrast::
-					ImageMean) {
-					actionableMap[Identifiers::
-						ActionableQualityFeedback::
-						    EmptyImageOrContrastTooLow] =
-					    muFeature.second;
-					isEmptyImage =
-					    (actionableMap[Identifiers::
-						     ActionableQualityFeedback::
-							 EmptyImageOrContrastTooLow] >
-							Thresholds::
-							    ActionableQualityFeedback::
-								EmptyImageOrContrastTooLow ?
-						    true :
-						    false);
-				}
+			const NativeQualityMeasureVector &muFeatures =
+			    muFeatureModule->getFeatureVector();
+			const unsigned int imageMean {
+				NativeQualityMeasureIndex::Contrast::ImageMean
+			};
+			if (muFeatures.has(imageMean)) {
+				const double mean {
+					muFeatures.data()[imageMean]
+				};
+				actionableMap[Identifiers::
+					ActionableQualityFeedback::
+					    EmptyImageOrContrastTooLow] = mean;
+				isEmptyImage = (mean >
+				    Thresholds::ActionableQualityFeedback::
+					EmptyImageOrContrastTooLow);
 			}
 
 			if (isEmptyImage || isUniformImage) {
@@ -162,18 +195,18 @@ NFIQ2::QualityMeasures::Impl::getActionableQualityFeedback(
 			const std::shared_ptr<FingerJetFX> fjfxFeatureModule =
 			    std::dynamic_pointer_cast<FingerJetFX>(feature);
 
-			for (const auto &fjfxFeature :
-			    fjfxFeatureModule->getFeatures()) {
-				if (fjfxFeature.first ==
-				    Identifiers::QualityMeasures::Minutiae::
-					Count) {
-					// return informative feature about
-					// number of minutiae
-					actionableMap[Identifiers::
-						ActionableQualityFeedback::
-						    FingerprintImageWithMinutiae] =
-					    fjfxFeature.second;
-				}
+			const NativeQualityMeasureVector &fjfxFeatures =
+			    fjfxFeatureModule->getFeatureVector();
+			const unsigned int count {
+				NativeQualityMeasureIndex::Minutiae::Count
+			};
+			if (fjfxFeatures.has(count)) {
+				// return informative feature about number of
+				// minutiae
+				actionableMap[Identifiers::
+					ActionableQualityFeedback::
+					    FingerprintImageWithMinutiae] =
+				    fjfxFeatures.data()[count];
 			}
 
 		} else if (feature->getName().compare(
@@ -211,44 +244,268 @@ NFIQ2::QualityMeasures::Impl::setFPU(unsigned int)
 
 std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasureAlgorithms(
-    const NFIQ2::FingerprintImageData &rawImage)
+    const NFIQ2::FingerprintImageView &rawImage)
 {
-	/* use double-precision rounding for 32-bit linux */
-	setFPU(0x27F);
+	return NFIQ2::QualityMeasures::Impl::
+	    computeNativeQualityMeasureAlgorithms(
+		rawImage, ComputationOptions {});
+}
 
-	const NFIQ2::FingerprintImageData croppedImage =
-	    rawImage.copyRemovingNearWhiteFrame();
+namespace {
+/** Position of each algorithm in computed algorithm vectors */
+enum AlgorithmSlot : size_t {
+	FDASlot = 0,
+	FingerJetFXSlot,
+	FJFXMinutiaeQualitySlot,
+	ImgProcROISlot,
+	LCSSlot,
+	MuSlot,
+	OCLHistogramSlot,
+	OFSlot,
+	QualityMapSlot,
+	RVUPHistogramSlot,
+
+	AlgorithmSlotCount
+};
 
-	std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
-	    features {};
+/**
+ * @return
+ * Slots of the algorithms identified by `algorithmIDs`.
+ *
+ * @throw NFIQ2::Exception
+ * `algorithmIDs` contains an unknown identifier.
+ */
+std::vector<bool>
+getRequestedSlots(const std::unordered_set<std::string> &algorithmIDs)
+{
+	/* Identifiers are listed in slot order */
+	const std::vector<std::string> ids =
+	    NFIQ2::QualityMeasures::Impl::getNativeQualityMeasureAlgorithmIDs();
+
+	std::vector<bool> requested(AlgorithmSlotCount, false);
+	for (const auto &algorithmID : algorithmIDs) {
+		const auto it = std::find(ids.cbegin(), ids.cend(),
+		    algorithmID);
+		if (it == ids.cend()) {
+			throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+			    "Unknown native quality measure algorithm: " +
+				algorithmID);
+		}
+		requested[static_cast<size_t>(it - ids.cbegin())] = true;
+	}
 
-	features.push_back(std::make_shared<FDA>(croppedImage));
+	return requested;
+}
 
-	std::shared_ptr<FingerJetFX> fjfxFeatureModule =
-	    std::make_shared<FingerJetFX>(croppedImage);
-	features.push_back(fjfxFeatureModule);
+/**
+ * @throw NFIQ2::Exception
+ * The Contrast algorithm finds the image to be uniform or empty.
+ */
+void
+throwIfUniformOrEmptyImage(const NFIQ2::QualityMeasures::Mu &muFeatureModule)
+{
+	const double sigma = muFeatureModule.getSigma();
+	const NFIQ2::QualityMeasures::NativeQualityMeasureVector &features =
+	    muFeatureModule.getFeatureVector();
+	if (!features.has(NFIQ2::QualityMeasures::NativeQualityMeasureIndex::
+		    Contrast::ImageMean)) {
+		throw NFIQ2::Exception(
+		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
+		    "Contrast image mean has not been computed");
+	}
+	const double mean = features.data()[NFIQ2::QualityMeasures::
+		NativeQualityMeasureIndex::Contrast::ImageMean];
+
+	if ((sigma < NFIQ2::Thresholds::ActionableQualityFeedback::
+			UniformImage) ||
+	    (mean > NFIQ2::Thresholds::ActionableQualityFeedback::
+			EmptyImageOrContrastTooLow)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::UniformOrEmptyImage,
+		    "Image is uniform or empty (standard deviation = " +
+			std::to_string(sigma) +
+			", mean = " + std::to_string(mean) + ")");
+	}
+}
+}
 
-	features.push_back(std::make_shared<FJFXMinutiaeQuality>(croppedImage,
-	    fjfxFeatureModule->getMinutiaData()));
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options)
+{
+	const std::vector<std::string> ids =
+	    getNativeQualityMeasureAlgorithmIDs();
+	return NFIQ2::QualityMeasures::Impl::
+	    computeNativeQualityMeasureAlgorithms(rawImage,
+		std::unordered_set<std::string>(ids.cbegin(), ids.cend()),
+		options);
+}
 
-	std::shared_ptr<ImgProcROI> roiFeatureModule =
-	    std::make_shared<ImgProcROI>(croppedImage);
-	features.push_back(roiFeatureModule);
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+NFIQ2::QualityMeasures::Impl::computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options)
+{
+	const std::vector<bool> requested = getRequestedSlots(algorithmIDs);
 
-	features.push_back(std::make_shared<LCS>(croppedImage));
+	/* Algorithms computed, including those requested ones depend on */
+	std::vector<bool> computed { requested };
+	if (requested[FJFXMinutiaeQualitySlot]) {
+		computed[FingerJetFXSlot] = true;
+	}
+	if (requested[QualityMapSlot]) {
+		computed[ImgProcROISlot] = true;
+	}
 
-	features.push_back(std::make_shared<Mu>(croppedImage));
+	/* use double-precision rounding for 32-bit linux */
+	setFPU(0x27F);
 
-	features.push_back(std::make_shared<OCLHistogram>(croppedImage));
+	/* view of rawImage's pixels, valid while rawImage is */
+	const NFIQ2::FingerprintImageView croppedImage =
+	    rawImage.viewRemovingNearWhiteFrame();
 
-	features.push_back(std::make_shared<OF>(croppedImage));
+	/* Contrast is cheap, check it before starting anything else */
+	std::shared_ptr<Mu> muFeatureModule {};
+	if (options.rejectUniformOrEmptyImages) {
+		muFeatureModule = std::make_shared<Mu>(croppedImage);
+		throwIfUniformOrEmptyImage(*muFeatureModule);
+	}
 
-	features.push_back(std::make_shared<QualityMap>(croppedImage,
-	    roiFeatureModule->getImgProcResults()));
+	/* intermediate results shared by the block-based modules */
+	FeatureContext::ParallelFor blockParallelFor {};
+	if (options.blockThreadCount != 1) {
+		blockParallelFor = [&options](const int count,
+				       const std::function<void(int)> &task) {
+			if (count > 0) {
+				parallelFor(static_cast<size_t>(count),
+				    options.blockThreadCount, options.executor,
+				    [&task](size_t i) {
+					    task(static_cast<int>(i));
+				    });
+			}
+		};
+	}
+	const FeatureContext context { croppedImage, blockParallelFor };
+
+	std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+	    features(AlgorithmSlotCount);
+
+	/*
+	 * Report the same error as computing the algorithms one after
+	 * another would: the one of the first failing slot. Algorithms after
+	 * a failed slot need not be computed.
+	 */
+	std::vector<std::exception_ptr> errors(AlgorithmSlotCount);
+	std::atomic<size_t> firstErrorSlot { AlgorithmSlotCount };
+	const auto compute =
+	    [&](const size_t slot,
+		const std::function<std::shared_ptr<
+		    NFIQ2::QualityMeasures::Algorithm>()> &algorithm) -> bool {
+		    if (!computed[slot] || (slot > firstErrorSlot)) {
+			    return false;
+		    }
+
+		    try {
+			    features[slot] = algorithm();
+			    return true;
+		    } catch (...) {
+			    errors[slot] = std::current_exception();
+			    size_t expected = firstErrorSlot;
+			    while ((slot < expected) &&
+				!firstErrorSlot.compare_exchange_weak(
+				    expected, slot)) { }
+			    return false;
+		    }
+	    };
+
+	/* Algorithms depending on another one run after it in the same job */
+	const std::vector<std::function<void()>> jobs {
+		[&]() {
+			compute(FDASlot,
+			    [&]() { return std::make_shared<FDA>(context); });
+		},
+		[&]() {
+			std::shared_ptr<FingerJetFX> fjfxFeatureModule {};
+			if (compute(FingerJetFXSlot, [&]() -> std::shared_ptr<
+				    NFIQ2::QualityMeasures::Algorithm> {
+				    fjfxFeatureModule =
+					std::make_shared<FingerJetFX>(
+					    croppedImage);
+				    return fjfxFeatureModule;
+			    })) {
+				compute(FJFXMinutiaeQualitySlot, [&]() {
+					return std::make_shared<
+					    FJFXMinutiaeQuality>(croppedImage,
+					    fjfxFeatureModule->getMinutiaData());
+				});
+			}
+		},
+		[&]() {
+			std::shared_ptr<ImgProcROI> roiFeatureModule {};
+			if (compute(ImgProcROISlot, [&]() -> std::shared_ptr<
+				    NFIQ2::QualityMeasures::Algorithm> {
+				    roiFeatureModule =
+					std::make_shared<ImgProcROI>(
+					    croppedImage);
+				    return roiFeatureModule;
+			    })) {
+				compute(QualityMapSlot, [&]() {
+					return std::make_shared<QualityMap>(
+					    context,
+					    roiFeatureModule
+						->getImgProcResults());
+				});
+			}
+		},
+		[&]() {
+			compute(LCSSlot,
+			    [&]() { return std::make_shared<LCS>(context); });
+		},
+		[&]() {
+			compute(MuSlot, [&]() -> std::shared_ptr<
+					    NFIQ2::QualityMeasures::Algorithm> {
+				if (muFeatureModule) {
+					return muFeatureModule;
+				}
+				return std::make_shared<Mu>(croppedImage);
+			});
+		},
+		[&]() {
+			compute(OCLHistogramSlot, [&]() {
+				return std::make_shared<OCLHistogram>(
+				    context);
+			});
+		},
+		[&]() {
+			compute(OFSlot,
+			    [&]() { return std::make_shared<OF>(context); });
+		},
+		[&]() {
+			compute(RVUPHistogramSlot, [&]() {
+				return std::make_shared<RVUPHistogram>(context);
+			});
+		}
+	};
+
+	parallelFor(jobs.size(), options.algorithmThreadCount,
+	    options.executor, [&jobs](size_t i) { jobs[i](); });
+
+	for (const auto &error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
 
-	features.push_back(std::make_shared<RVUPHistogram>(croppedImage));
+	std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+	    requestedFeatures {};
+	for (size_t slot = 0; slot < AlgorithmSlotCount; slot++) {
+		if (requested[slot]) {
+			requestedFeatures.push_back(features[slot]);
+		}
+	}
 
-	return features;
+	return requestedFeatures;
 }
 
 std::unordered_map<std::string,
@@ -2,12 +2,14 @@
 #define NFIQ2_QUALITYMEASURES_IMPL_HPP_
 
 #include <nfiq2_fingerprintimagedata.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <nfiq2_qualitymeasures.hpp>
 #include <quality_modules/Module.h>
 
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace NFIQ2 { namespace QualityMeasures { namespace Impl {
@@ -38,21 +40,46 @@ void setFPU(unsigned int mode);
 
 std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 computeNativeQualityMeasureAlgorithms(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage);
+
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options);
+
+std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+computeNativeQualityMeasureAlgorithms(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options);
 
 std::unordered_map<std::string, double> getActionableQualityFeedback(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	&algorithms);
 
 std::unordered_map<std::string, double> computeActionableQualityFeedback(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage);
 
 std::unordered_map<std::string, double> getNativeQualityMeasures(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	&algorithms);
 
+/** Native quality measures of `algorithms`, without building a map */
+NativeQualityMeasureVector getNativeQualityMeasureVector(
+    const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
+	&algorithms);
+
+std::unordered_map<std::string, double> computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage);
+
+std::unordered_map<std::string, double> computeNativeQualityMeasures(
+    const NFIQ2::FingerprintImageView &rawImage,
+    const ComputationOptions &options);
+
 std::unordered_map<std::string, double> computeNativeQualityMeasures(
-    const NFIQ2::FingerprintImageData &rawImage);
+    const NFIQ2::FingerprintImageView &rawImage,
+    const std::unordered_set<std::string> &algorithmIDs,
+    const ComputationOptions &options);
 
 std::unordered_map<std::string, double> getNativeQualityMeasureAlgorithmSpeeds(
     const std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
@@ -0,0 +1,181 @@
+#include <nfiq2_exception.hpp>
+#include <prediction/BinaryRandomForest.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace {
+/** Identifies binary random forests */
+const char Magic[8] { 'N', 'F', 'I', 'Q', '2', 'R', 'F', '\0' };
+
+using Node = NFIQ2::Prediction::FlatRandomForest::Node;
+using QuantizedNode = NFIQ2::Prediction::QuantizedRandomForest::Node;
+using Header = NFIQ2::Prediction::BinaryRandomForest::Header;
+
+static_assert(sizeof(Node) == 12, "Node must not be padded");
+static_assert(sizeof(QuantizedNode) == 8, "Node must not be padded");
+static_assert(sizeof(Header) == 32, "Header must not be padded");
+
+/** @return Quantized forest stored after the nodes of a model */
+std::shared_ptr<const NFIQ2::Prediction::QuantizedRandomForest>
+readQuantized(const Header &header, const uint8_t *data,
+    const size_t size, const uint32_t *roots,
+    const std::shared_ptr<const void> &storage)
+{
+	// sizes are checked one at a time to avoid overflows
+	size_t remaining { size };
+	if (header.featureCount >= remaining / sizeof(uint32_t)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest is truncated");
+	}
+	const uint8_t *thresholdOffsets { data };
+	const size_t offsetCount { header.featureCount + size_t { 1 } };
+	remaining -= offsetCount * sizeof(uint32_t);
+
+	uint32_t thresholdCount {};
+	std::memcpy(&thresholdCount,
+	    thresholdOffsets + (header.featureCount * sizeof(uint32_t)),
+	    sizeof(thresholdCount));
+	if (thresholdCount > remaining / sizeof(float)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest is truncated");
+	}
+	const uint8_t *thresholds { thresholdOffsets +
+		(offsetCount * sizeof(uint32_t)) };
+	remaining -= thresholdCount * sizeof(float);
+
+	if ((header.nodeCount != remaining / sizeof(QuantizedNode)) ||
+	    (remaining % sizeof(QuantizedNode) != 0)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest has an unexpected size");
+	}
+	const uint8_t *nodes { thresholds + (thresholdCount * sizeof(float)) };
+
+	return std::make_shared<
+	    const NFIQ2::Prediction::QuantizedRandomForest>(
+	    reinterpret_cast<const QuantizedNode *>(nodes),
+	    static_cast<size_t>(header.nodeCount), roots, header.treeCount,
+	    reinterpret_cast<const float *>(thresholds),
+	    reinterpret_cast<const uint32_t *>(thresholdOffsets),
+	    header.featureCount, storage);
+}
+}
+
+bool
+NFIQ2::Prediction::BinaryRandomForest::isBinaryRandomForest(
+    const uint8_t *data, const size_t size)
+{
+	return ((size >= sizeof(Magic)) &&
+	    (std::memcmp(data, Magic, sizeof(Magic)) == 0));
+}
+
+NFIQ2::Prediction::FlatRandomForest
+NFIQ2::Prediction::BinaryRandomForest::read(const uint8_t *data,
+    const size_t size, std::shared_ptr<const void> storage)
+{
+	if ((size < sizeof(Header)) || !isBinaryRandomForest(data, size)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Not a binary random forest");
+	}
+
+	Header header {};
+	std::memcpy(&header, data, sizeof(header));
+	if ((header.version < MinimumVersion) || (header.version > Version)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Unsupported binary random forest version (" +
+			std::to_string(header.version) + ')');
+	}
+	if (header.byteOrder != ByteOrderMark) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest was written with a different byte "
+		    "order");
+	}
+
+	// sizes are checked one at a time to avoid overflows
+	size_t remaining { size - sizeof(Header) };
+	if (header.treeCount > remaining / sizeof(uint32_t)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest is truncated");
+	}
+	remaining -= header.treeCount * sizeof(uint32_t);
+	// version 1 models end with the nodes
+	if ((header.version == 1) &&
+	    ((header.nodeCount != remaining / sizeof(Node)) ||
+		(remaining % sizeof(Node) != 0))) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest has an unexpected size");
+	}
+	if (header.nodeCount > remaining / sizeof(Node)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest is truncated");
+	}
+	remaining -= static_cast<size_t>(header.nodeCount) * sizeof(Node);
+
+	const uint8_t *roots { data + sizeof(Header) };
+	const uint8_t *nodes { roots + (header.treeCount * sizeof(uint32_t)) };
+	if ((reinterpret_cast<uintptr_t>(nodes) % alignof(Node)) != 0) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest is not aligned");
+	}
+
+	FlatRandomForest forest(reinterpret_cast<const Node *>(nodes),
+	    static_cast<size_t>(header.nodeCount),
+	    reinterpret_cast<const uint32_t *>(roots), header.treeCount,
+	    header.featureCount, storage);
+	if (header.version >= 2) {
+		// all sections are multiples of 4 bytes, as aligned as nodes
+		forest.useQuantized(readQuantized(header,
+		    nodes + (header.nodeCount * sizeof(Node)), remaining,
+		    reinterpret_cast<const uint32_t *>(roots), storage));
+	}
+
+	return forest;
+}
+
+void
+NFIQ2::Prediction::BinaryRandomForest::write(std::ostream &out,
+    const FlatRandomForest &forest)
+{
+	// forests that cannot be quantized are written without quantized
+	// forest, as version 1
+	std::unique_ptr<QuantizedRandomForest> quantized {};
+	try {
+		quantized.reset(new QuantizedRandomForest(forest));
+	} catch (const NFIQ2::Exception &) {}
+
+	Header header {};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = quantized ? Version : 1;
+	header.byteOrder = ByteOrderMark;
+	header.featureCount = forest.getFeatureCount();
+	header.treeCount = forest.getTreeCount();
+	header.nodeCount = forest.getNodeCount();
+
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char *>(forest.getRoots()),
+	    static_cast<std::streamsize>(
+		forest.getTreeCount() * sizeof(uint32_t)));
+	for (size_t i {}; i < forest.getNodeCount(); ++i) {
+		// reserved bytes are always written as 0
+		Node node = forest.getNodes()[i];
+		node.reserved = 0;
+		out.write(reinterpret_cast<const char *>(&node), sizeof(node));
+	}
+	if (!quantized) {
+		return;
+	}
+
+	const uint32_t *thresholdOffsets { quantized->getThresholdOffsets() };
+	const uint32_t thresholdCount {
+		thresholdOffsets[quantized->getFeatureCount()]
+	};
+	out.write(reinterpret_cast<const char *>(thresholdOffsets),
+	    static_cast<std::streamsize>(
+		(quantized->getFeatureCount() + 1) * sizeof(uint32_t)));
+	out.write(reinterpret_cast<const char *>(quantized->getThresholds()),
+	    static_cast<std::streamsize>(thresholdCount * sizeof(float)));
+	out.write(reinterpret_cast<const char *>(quantized->getNodes()),
+	    static_cast<std::streamsize>(
+		quantized->getNodeCount() * sizeof(QuantizedNode)));
+}
@@ -0,0 +1,560 @@
+#include <nfiq2_exception.hpp>
+#include <prediction/FlatRandomForest.h>
+#include <prediction/QuantizedRandomForest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+NFIQ2::Prediction::FlatRandomForest::FlatRandomForest(const Node *nodes,
+    const size_t nodeCount, const uint32_t *roots, const size_t treeCount,
+    const unsigned int featureCount, std::shared_ptr<const void> storage)
+    : storage_ { std::move(storage) }
+    , nodes_ { nodes }
+    , nodeCount_ { nodeCount }
+    , roots_ { roots }
+    , treeCount_ { treeCount }
+    , featureCount_ { featureCount }
+{
+	/*
+	 * Children always follow their parent, so evaluation terminates and
+	 * stays within the nodes whatever their origin.
+	 */
+	for (size_t i {}; i < nodeCount; ++i) {
+		const Node &node = nodes[i];
+		if (node.feature == LeafFeature) {
+			continue;
+		}
+		if ((node.feature >= featureCount) || (i + 1 >= nodeCount) ||
+		    (node.greaterChild <= i) ||
+		    (node.greaterChild >= nodeCount)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid random forest node " + std::to_string(i));
+		}
+	}
+	for (size_t i {}; i < treeCount; ++i) {
+		if (roots[i] >= nodeCount) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid random forest root " + std::to_string(i));
+		}
+	}
+
+	this->computeVoteBounds();
+}
+
+void
+NFIQ2::Prediction::FlatRandomForest::computeVoteBounds()
+{
+	/* Integers up to this magnitude sum exactly in double precision */
+	static const float MaxExactVote { 1 << 24 };
+
+	this->exactVotes_ = true;
+	this->remainingVotes_.assign(this->treeCount_ + 1, VoteBounds {});
+
+	std::vector<uint32_t> pending {};
+	for (size_t t { this->treeCount_ }; t-- > 0;) {
+		VoteBounds tree { std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity() };
+		pending.assign(1, this->roots_[t]);
+		while (!pending.empty()) {
+			const Node &node = this->nodes_[pending.back()];
+			pending.pop_back();
+			if (node.feature != LeafFeature) {
+				pending.push_back(static_cast<uint32_t>(
+				    &node - this->nodes_ + 1));
+				pending.push_back(node.greaterChild);
+				continue;
+			}
+
+			tree.min = std::min(tree.min,
+			    static_cast<double>(node.value));
+			tree.max = std::max(tree.max,
+			    static_cast<double>(node.value));
+			this->exactVotes_ &=
+			    ((std::floor(node.value) == node.value) &&
+				(std::fabs(node.value) <= MaxExactVote));
+		}
+
+		this->remainingVotes_[t].min =
+		    this->remainingVotes_[t + 1].min + tree.min;
+		this->remainingVotes_[t].max =
+		    this->remainingVotes_[t + 1].max + tree.max;
+	}
+}
+
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+namespace {
+/** Nodes and roots of a forest flattened from OpenCV */
+struct FlattenedStorage {
+	std::vector<NFIQ2::Prediction::FlatRandomForest::Node> nodes {};
+	std::vector<uint32_t> roots {};
+};
+}
+
+NFIQ2::Prediction::FlatRandomForest::FlatRandomForest(
+    const cv::ml::DTrees &trees, const cv::FileNode &params)
+{
+	if (!params["missing_subst"].empty()) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Substitutes for missing values are not supported");
+	}
+
+	const int featureCount { trees.getVarCount() };
+	if ((featureCount <= 0) || (featureCount >= LeafFeature)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Unsupported number of features (" +
+			std::to_string(featureCount) + ')');
+	}
+
+	/*
+	 * Splits reference variables, which OpenCV maps to sample columns
+	 * through var_idx when the forest only uses some of them.
+	 */
+	std::vector<int> variableIndices {};
+	const cv::FileNode varIdxNode = params["var_idx"];
+	if (!varIdxNode.empty()) {
+		if (varIdxNode.isSeq()) {
+			varIdxNode >> variableIndices;
+		} else {
+			cv::Mat varIdx {};
+			varIdxNode >> varIdx;
+			varIdx.convertTo(varIdx, CV_32S);
+			varIdx = varIdx.reshape(1, 1);
+			variableIndices.assign(varIdx.ptr<int>(0),
+			    varIdx.ptr<int>(0) + varIdx.cols);
+		}
+	}
+	std::vector<int> featureOfVariable {};
+	for (size_t i {}; i < variableIndices.size(); ++i) {
+		const int variable { variableIndices[i] };
+		if (variable < 0) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid variable index");
+		}
+		if (static_cast<size_t>(variable) >= featureOfVariable.size()) {
+			featureOfVariable.resize(
+			    static_cast<size_t>(variable) + 1, -1);
+		}
+		featureOfVariable[static_cast<size_t>(variable)] =
+		    static_cast<int>(i);
+	}
+
+	const auto storage = std::make_shared<FlattenedStorage>();
+	const std::vector<int> &roots = trees.getRoots();
+	storage->roots.reserve(roots.size());
+	storage->nodes.reserve(trees.getNodes().size());
+	for (const int root : roots) {
+		storage->roots.push_back(appendSubtree(trees, root,
+		    featureOfVariable, static_cast<unsigned int>(featureCount),
+		    storage->nodes));
+	}
+
+	*this = FlatRandomForest(storage->nodes.data(), storage->nodes.size(),
+	    storage->roots.data(), storage->roots.size(),
+	    static_cast<unsigned int>(featureCount), storage);
+}
+
+uint32_t
+NFIQ2::Prediction::FlatRandomForest::appendSubtree(
+    const cv::ml::DTrees &trees, const int nodeIndex,
+    const std::vector<int> &featureOfVariable,
+    const unsigned int featureCount, std::vector<Node> &nodes)
+{
+	const std::vector<cv::ml::DTrees::Node> &cvNodes = trees.getNodes();
+	const std::vector<cv::ml::DTrees::Split> &cvSplits = trees.getSplits();
+
+	if ((nodeIndex < 0) ||
+	    (static_cast<size_t>(nodeIndex) >= cvNodes.size())) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Invalid node index");
+	}
+	const cv::ml::DTrees::Node &cvNode = cvNodes[
+	    static_cast<size_t>(nodeIndex)];
+
+	const uint32_t index { static_cast<uint32_t>(nodes.size()) };
+	nodes.push_back(Node {});
+
+	/* Leaf */
+	if (cvNode.split < 0) {
+		const float value { static_cast<float>(cvNode.value) };
+		if (static_cast<double>(value) != cvNode.value) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Leaf value is not representable as float");
+		}
+		nodes[index].value = value;
+		nodes[index].feature = LeafFeature;
+		return index;
+	}
+
+	/* Only the primary split is used for prediction */
+	if (static_cast<size_t>(cvNode.split) >= cvSplits.size()) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Invalid split index");
+	}
+	const cv::ml::DTrees::Split &cvSplit = cvSplits[
+	    static_cast<size_t>(cvNode.split)];
+	if (cvSplit.subsetOfs >= 0) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Categorical splits are not supported");
+	}
+
+	int feature { cvSplit.varIdx };
+	if (!featureOfVariable.empty()) {
+		feature = ((feature >= 0) &&
+			      (static_cast<size_t>(feature) <
+				  featureOfVariable.size())) ?
+		    featureOfVariable[static_cast<size_t>(feature)] :
+		    -1;
+	}
+	if ((feature < 0) ||
+	    (static_cast<unsigned int>(feature) >= featureCount)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Split on unknown variable " +
+			std::to_string(cvSplit.varIdx));
+	}
+
+	/*
+	 * OpenCV goes left when the feature is less than or equal to the
+	 * threshold, unless the split is inversed. Missing features follow
+	 * the default direction of the node regardless of inversion.
+	 */
+	const int lessOrEqualChild { cvSplit.inversed ? cvNode.right :
+							cvNode.left };
+	const int greaterChild { cvSplit.inversed ? cvNode.left :
+						    cvNode.right };
+	const int missingChild { cvNode.defaultDir < 0 ? cvNode.left :
+							 cvNode.right };
+
+	nodes[index].value = cvSplit.c;
+	nodes[index].feature = static_cast<uint16_t>(feature);
+	nodes[index].missingLessOrEqual = (missingChild == lessOrEqualChild);
+
+	appendSubtree(trees, lessOrEqualChild, featureOfVariable, featureCount,
+	    nodes);
+	const uint32_t greaterIndex { appendSubtree(trees, greaterChild,
+	    featureOfVariable, featureCount, nodes) };
+	nodes[index].greaterChild = greaterIndex;
+
+	return index;
+}
+#endif /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
+
+bool
+NFIQ2::Prediction::FlatRandomForest::empty() const
+{
+	return (this->treeCount_ == 0);
+}
+
+unsigned int
+NFIQ2::Prediction::FlatRandomForest::getTreeCount() const
+{
+	return static_cast<unsigned int>(this->treeCount_);
+}
+
+unsigned int
+NFIQ2::Prediction::FlatRandomForest::getFeatureCount() const
+{
+	return this->featureCount_;
+}
+
+const NFIQ2::Prediction::FlatRandomForest::Node *
+NFIQ2::Prediction::FlatRandomForest::getNodes() const
+{
+	return this->nodes_;
+}
+
+size_t
+NFIQ2::Prediction::FlatRandomForest::getNodeCount() const
+{
+	return this->nodeCount_;
+}
+
+const uint32_t *
+NFIQ2::Prediction::FlatRandomForest::getRoots() const
+{
+	return this->roots_;
+}
+
+bool
+NFIQ2::Prediction::FlatRandomForest::quantize()
+{
+	try {
+		this->quantized_ =
+		    std::make_shared<const QuantizedRandomForest>(*this);
+	} catch (const NFIQ2::Exception &) {
+		/* Evaluated from the nodes as they are */
+		this->quantized_.reset();
+	}
+
+	return this->isQuantized();
+}
+
+void
+NFIQ2::Prediction::FlatRandomForest::useQuantized(
+    std::shared_ptr<const QuantizedRandomForest> quantized)
+{
+	if (!quantized ||
+	    (quantized->getFeatureCount() != this->featureCount_) ||
+	    (quantized->getTreeCount() != this->treeCount_) ||
+	    (quantized->getNodeCount() != this->nodeCount_) ||
+	    !std::equal(this->roots_, this->roots_ + this->treeCount_,
+		quantized->getRoots())) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Quantized random forest does not match its nodes");
+	}
+
+	/* Each quantized node must decide as the node it replaces */
+	const QuantizedRandomForest::Node *quantizedNodes {
+		quantized->getNodes()
+	};
+	const float *thresholds { quantized->getThresholds() };
+	const uint32_t *thresholdOffsets { quantized->getThresholdOffsets() };
+	for (size_t i {}; i < this->nodeCount_; ++i) {
+		const Node &node = this->nodes_[i];
+		const QuantizedRandomForest::Node &quantizedNode =
+		    quantizedNodes[i];
+		bool matches {};
+		if (node.feature == LeafFeature) {
+			uint32_t value {};
+			std::memcpy(&value, &node.value, sizeof(value));
+			matches = (quantizedNode.feature ==
+					  QuantizedRandomForest::LeafFeature) &&
+			    (quantizedNode.next == value);
+		} else {
+			const uint16_t missingLessOrEqual {
+				node.missingLessOrEqual ?
+				    QuantizedRandomForest::MissingLessOrEqual :
+				    uint16_t {}
+			};
+			const uint32_t first { thresholdOffsets[node.feature] };
+			const uint32_t last {
+				thresholdOffsets[node.feature + 1]
+			};
+			const unsigned int feature { static_cast<unsigned int>(
+				node.feature | missingLessOrEqual) };
+			matches = (quantizedNode.feature == feature) &&
+			    (quantizedNode.next == node.greaterChild) &&
+			    (quantizedNode.bin < last - first) &&
+			    (thresholds[first + quantizedNode.bin] ==
+				node.value);
+		}
+		if (!matches) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Quantized random forest node " +
+				std::to_string(i) + " does not match its node");
+		}
+	}
+
+	this->quantized_ = std::move(quantized);
+}
+
+bool
+NFIQ2::Prediction::FlatRandomForest::isQuantized() const
+{
+	return this->quantized_ != nullptr;
+}
+
+float
+NFIQ2::Prediction::FlatRandomForest::predict(const float *features) const
+{
+	if (this->quantized_) {
+		return this->quantized_->predict(features);
+	}
+
+	static const float MissingValue { std::numeric_limits<float>::max() };
+
+	bool anyMissing { false };
+	for (unsigned int i {}; i < this->featureCount_; ++i) {
+		anyMissing |= (features[i] == MissingValue);
+	}
+
+	const Node *nodes { this->nodes_ };
+
+	/* Sum in tree order, in double precision, as OpenCV does */
+	double sum {};
+	if (!anyMissing) {
+		for (size_t t {}; t < this->treeCount_; ++t) {
+			const uint32_t root { this->roots_[t] };
+			uint32_t n { root };
+			while (nodes[n].feature != LeafFeature) {
+				n = (features[nodes[n].feature] <=
+					nodes[n].value) ?
+				    n + 1 :
+				    nodes[n].greaterChild;
+			}
+			sum += nodes[n].value;
+		}
+	} else {
+		for (size_t t {}; t < this->treeCount_; ++t) {
+			const uint32_t root { this->roots_[t] };
+			uint32_t n { root };
+			while (nodes[n].feature != LeafFeature) {
+				const float feature { features[nodes[n]
+								   .feature] };
+				const bool lessOrEqual { (feature ==
+							     MissingValue) ?
+					(nodes[n].missingLessOrEqual != 0) :
+					(feature <= nodes[n].value) };
+				n = lessOrEqual ? n + 1 : nodes[n].greaterChild;
+			}
+			sum += nodes[n].value;
+		}
+	}
+
+	return static_cast<float>(sum);
+}
+
+void
+NFIQ2::Prediction::FlatRandomForest::predict(const float *features,
+    const size_t sampleCount, float *votes) const
+{
+	if (this->quantized_) {
+		this->quantized_->predict(features, sampleCount, votes);
+		return;
+	}
+
+	static const float MissingValue { std::numeric_limits<float>::max() };
+	/** Samples passing through a tree before the next tree */
+	static const size_t BlockSize { 256 };
+	/** Samples traversing a tree in lockstep */
+	static const size_t Lanes { 8 };
+
+	const Node *nodes { this->nodes_ };
+	const size_t featureCount { this->featureCount_ };
+
+	std::array<double, BlockSize> sums {};
+	for (size_t first {}; first < sampleCount; first += BlockSize) {
+		const size_t count { std::min(BlockSize, sampleCount - first) };
+		const float *block { features + (first * featureCount) };
+
+		/* Rare, keep the lockstep loop free of missing value checks */
+		if (std::find(block, block + (count * featureCount),
+			MissingValue) != block + (count * featureCount)) {
+			for (size_t i {}; i < count; ++i) {
+				votes[first + i] = this->predict(
+				    block + (i * featureCount));
+			}
+			continue;
+		}
+
+		/* Sum in tree order for every sample, as predict() does */
+		std::fill(sums.begin(), sums.begin() + count, 0.0);
+		for (size_t t {}; t < this->treeCount_; ++t) {
+			const uint32_t root { this->roots_[t] };
+			size_t i {};
+
+			/*
+			 * Interleave independent traversals to hide the
+			 * latency of dependent node loads.
+			 */
+			for (; i + Lanes <= count; i += Lanes) {
+				std::array<uint32_t, Lanes> n {};
+				n.fill(root);
+				bool active { true };
+				while (active) {
+					active = false;
+					for (size_t l {}; l < Lanes; ++l) {
+						const Node &node = nodes[n[l]];
+						if (node.feature ==
+						    LeafFeature) {
+							continue;
+						}
+						active = true;
+						n[l] = (block[((i + l) *
+							       featureCount) +
+							    node.feature] <=
+							   node.value) ?
+						    n[l] + 1 :
+						    node.greaterChild;
+					}
+				}
+				for (size_t l {}; l < Lanes; ++l) {
+					sums[i + l] += nodes[n[l]].value;
+				}
+			}
+
+			for (; i < count; ++i) {
+				const float *sample { block +
+					(i * featureCount) };
+				uint32_t n { root };
+				while (nodes[n].feature != LeafFeature) {
+					n = (sample[nodes[n].feature] <=
+						nodes[n].value) ?
+					    n + 1 :
+					    nodes[n].greaterChild;
+				}
+				sums[i] += nodes[n].value;
+			}
+		}
+
+		for (size_t i {}; i < count; ++i) {
+			votes[first + i] = static_cast<float>(sums[i]);
+		}
+	}
+}
+
+uint32_t
+NFIQ2::Prediction::FlatRandomForest::findLeaf(
+    const float *features, const uint32_t root) const
+{
+	static const float MissingValue { std::numeric_limits<float>::max() };
+
+	const Node *nodes { this->nodes_ };
+	uint32_t n { root };
+	while (nodes[n].feature != LeafFeature) {
+		const float feature { features[nodes[n].feature] };
+		const bool lessOrEqual { (feature == MissingValue) ?
+			(nodes[n].missingLessOrEqual != 0) :
+			(feature <= nodes[n].value) };
+		n = lessOrEqual ? n + 1 : nodes[n].greaterChild;
+	}
+
+	return n;
+}
+
+bool
+NFIQ2::Prediction::FlatRandomForest::decide(const float *features,
+    const std::function<bool(float)> &accept,
+    unsigned int &treesEvaluated) const
+{
+	/* Each sample is quantized once for all trees */
+	std::array<uint16_t, QuantizedRandomForest::MaxFeatureCount> bins;
+	if (this->quantized_) {
+		this->quantized_->quantize(features, bins.data());
+	}
+	const auto leafValue = [&](const uint32_t root) {
+		return this->quantized_ ?
+		    this->quantized_->getLeafValue(
+			this->quantized_->findLeaf(bins.data(), root)) :
+		    this->nodes_[this->findLeaf(features, root)].value;
+	};
+
+	/* Sum in tree order, in double precision, as predict() does */
+	double sum {};
+	for (size_t t {}; t < this->treeCount_; ++t) {
+		if (this->exactVotes_) {
+			const VoteBounds &remaining = this->remainingVotes_[t];
+			const bool acceptFewest { accept(
+			    static_cast<float>(sum + remaining.min)) };
+			if (acceptFewest == accept(static_cast<float>(
+						sum + remaining.max))) {
+				treesEvaluated = static_cast<unsigned int>(t);
+				return acceptFewest;
+			}
+		}
+
+		sum += leafValue(this->roots_[t]);
+	}
+
+	treesEvaluated = static_cast<unsigned int>(this->treeCount_);
+	return accept(static_cast<float>(sum));
+}
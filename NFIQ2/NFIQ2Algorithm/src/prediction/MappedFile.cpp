@@ -0,0 +1,122 @@
+#include <nfiq2_exception.hpp>
+#include <prediction/MappedFile.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <limits>
+
+#ifdef _WIN32
+NFIQ2::Prediction::MappedFile::MappedFile(const std::string &path)
+{
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ,
+	    FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+	    nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to open " + path);
+	}
+
+	LARGE_INTEGER fileSize {};
+	if (!GetFileSizeEx(file, &fileSize) ||
+	    (static_cast<unsigned long long>(fileSize.QuadPart) >
+		std::numeric_limits<size_t>::max())) {
+		CloseHandle(file);
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to determine the size of " + path);
+	}
+	this->size_ = static_cast<size_t>(fileSize.QuadPart);
+	if (this->size_ == 0) {
+		CloseHandle(file);
+		return;
+	}
+
+	// the view keeps the mapping, and the mapping the file, alive
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY,
+	    0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to map " + path);
+	}
+	this->data_ = static_cast<const uint8_t *>(
+	    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	CloseHandle(mapping);
+	if (this->data_ == nullptr) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to map " + path);
+	}
+}
+
+NFIQ2::Prediction::MappedFile::~MappedFile()
+{
+	if (this->data_ != nullptr) {
+		UnmapViewOfFile(this->data_);
+	}
+}
+#else
+NFIQ2::Prediction::MappedFile::MappedFile(const std::string &path)
+{
+	const int fd { open(path.c_str(), O_RDONLY) };
+	if (fd == -1) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to open " + path);
+	}
+
+	struct stat sb {};
+	if ((fstat(fd, &sb) == -1) || (sb.st_size < 0) ||
+	    (static_cast<unsigned long long>(sb.st_size) >
+		std::numeric_limits<size_t>::max())) {
+		close(fd);
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to determine the size of " + path);
+	}
+	this->size_ = static_cast<size_t>(sb.st_size);
+	if (this->size_ == 0) {
+		close(fd);
+		return;
+	}
+
+	// the mapping keeps the file alive
+	void *const mapping = mmap(nullptr, this->size_, PROT_READ,
+	    MAP_SHARED, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Failed to map " + path);
+	}
+	this->data_ = static_cast<const uint8_t *>(mapping);
+}
+
+NFIQ2::Prediction::MappedFile::~MappedFile()
+{
+	if (this->data_ != nullptr) {
+		munmap(const_cast<uint8_t *>(this->data_), this->size_);
+	}
+}
+#endif
+
+const uint8_t *
+NFIQ2::Prediction::MappedFile::data() const
+{
+	return this->data_;
+}
+
+size_t
+NFIQ2::Prediction::MappedFile::size() const
+{
+	return this->size_;
+}
@@ -0,0 +1,126 @@
+#include <prediction/ModelRegistry.h>
+
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+/** Models that are still in use or being loaded, by key */
+struct RegisteredModel {
+	std::weak_ptr<const NFIQ2::Prediction::RandomForestML> forest {};
+	std::string parameterHash {};
+	/** Valid while the model is being loaded */
+	std::shared_future<NFIQ2::Prediction::ModelRegistry::Model>
+	    loading {};
+};
+
+/** @return Key of a model loaded from `source` with hash `hash` */
+std::string
+makeKey(const std::string &source, const std::string &hash)
+{
+	// '\0' cannot appear in paths, so keys of distinct pairs differ
+	return source + '\0' + hash;
+}
+}
+
+NFIQ2::Prediction::ModelRegistry::Model
+NFIQ2::Prediction::ModelRegistry::getOrLoad(const std::string &key,
+    const std::function<std::string(RandomForestML &)> &load)
+{
+	static std::mutex registryMutex {};
+	static std::unordered_map<std::string, RegisteredModel> registry {};
+
+	std::promise<Model> loaded {};
+	std::shared_future<Model> loading {};
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+
+		// forget models no longer used by anyone
+		for (auto it = registry.begin(); it != registry.end();) {
+			if (!it->second.loading.valid() &&
+			    it->second.forest.expired()) {
+				it = registry.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		RegisteredModel &registered = registry[key];
+		Model model {};
+		model.forest = registered.forest.lock();
+		model.parameterHash = registered.parameterHash;
+		if (model.forest) {
+			return model;
+		}
+
+		if (registered.loading.valid()) {
+			loading = registered.loading;
+		} else {
+			// this thread loads, others wait for the result
+			registered.loading = loaded.get_future().share();
+		}
+	}
+	if (loading.valid()) {
+		// rethrows if loading failed
+		return loading.get();
+	}
+
+	// load outside the lock, so that other models are not delayed
+	Model model {};
+	try {
+		const auto forest = std::make_shared<RandomForestML>();
+		model.parameterHash = load(*forest);
+		model.forest = forest;
+	} catch (...) {
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			registry.erase(key);
+		}
+		loaded.set_exception(std::current_exception());
+		throw;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		RegisteredModel &registered = registry[key];
+		registered.forest = model.forest;
+		registered.parameterHash = model.parameterHash;
+		registered.loading = {};
+	}
+	loaded.set_value(model);
+
+	return model;
+}
+
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
+NFIQ2::Prediction::ModelRegistry::Model
+NFIQ2::Prediction::ModelRegistry::getEmbedded()
+{
+	// empty source, so it cannot collide with models from files
+	return getOrLoad(makeKey("", "embedded"),
+	    [](RandomForestML &forest) { return forest.initModule(); });
+}
+#endif
+
+NFIQ2::Prediction::ModelRegistry::Model
+NFIQ2::Prediction::ModelRegistry::get(
+    const std::string &fileName, const std::string &fileHash)
+{
+	return getOrLoad(makeKey(fileName, fileHash),
+	    [&](RandomForestML &forest) {
+		    return forest.initModule(fileName, fileHash);
+	    });
+}
+
+#ifdef __ANDROID__
+NFIQ2::Prediction::ModelRegistry::Model
+NFIQ2::Prediction::ModelRegistry::get(AAssetManager *assets,
+    const std::string &fileName, const std::string &fileHash)
+{
+	// assets and files are distinct sources even with the same path
+	return getOrLoad(makeKey("asset:" + fileName, fileHash),
+	    [&](RandomForestML &forest) {
+		    return forest.initModule(assets, fileName, fileHash);
+	    });
+}
+#endif
@@ -0,0 +1,388 @@
+#include <nfiq2_exception.hpp>
+#include <prediction/QuantizedRandomForest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+static_assert(sizeof(NFIQ2::Prediction::QuantizedRandomForest::Node) == 8,
+    "Quantized nodes are expected to be packed in 8 bytes");
+static_assert(NFIQ2::Prediction::QuantizedRandomForest::MaxFeatureCount <
+	NFIQ2::Prediction::QuantizedRandomForest::LeafFeature,
+    "Feature indices must not collide with LeafFeature");
+static_assert(alignof(NFIQ2::Prediction::QuantizedRandomForest::Node) ==
+	alignof(uint32_t),
+    "Quantized nodes are expected to be aligned as their tables");
+
+namespace {
+/** Tables of a quantized forest built in memory */
+struct QuantizedTables {
+	std::vector<uint32_t> roots {};
+	std::vector<NFIQ2::Prediction::QuantizedRandomForest::Node> nodes {};
+	std::vector<float> thresholds {};
+	std::vector<uint32_t> thresholdOffsets {};
+};
+}
+
+NFIQ2::Prediction::QuantizedRandomForest::QuantizedRandomForest(
+    const FlatRandomForest &forest)
+{
+	const unsigned int featureCount { forest.getFeatureCount() };
+	if (featureCount > MaxFeatureCount) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Too many features to quantize (" +
+			std::to_string(featureCount) + ')');
+	}
+
+	const FlatRandomForest::Node *nodes { forest.getNodes() };
+	const size_t nodeCount { forest.getNodeCount() };
+	const auto tables = std::make_shared<QuantizedTables>();
+	tables->roots.assign(
+	    forest.getRoots(), forest.getRoots() + forest.getTreeCount());
+
+	/* Distinct thresholds of each feature, in increasing order */
+	std::vector<std::vector<float>> thresholds(featureCount);
+	for (size_t i {}; i < nodeCount; ++i) {
+		if (nodes[i].feature == FlatRandomForest::LeafFeature) {
+			continue;
+		}
+		if (std::isnan(nodes[i].value)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Threshold of random forest node " +
+				std::to_string(i) + " is not a number");
+		}
+		thresholds[nodes[i].feature].push_back(nodes[i].value);
+	}
+
+	tables->thresholdOffsets.reserve(featureCount + 1);
+	for (auto &featureThresholds : thresholds) {
+		std::sort(featureThresholds.begin(), featureThresholds.end());
+		featureThresholds.erase(std::unique(featureThresholds.begin(),
+					    featureThresholds.end()),
+		    featureThresholds.end());
+		/* Bins range up to the number of thresholds */
+		if (featureThresholds.size() >= MissingBin) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Too many thresholds to quantize");
+		}
+
+		tables->thresholdOffsets.push_back(
+		    static_cast<uint32_t>(tables->thresholds.size()));
+		tables->thresholds.insert(tables->thresholds.end(),
+		    featureThresholds.cbegin(), featureThresholds.cend());
+	}
+	tables->thresholdOffsets.push_back(
+	    static_cast<uint32_t>(tables->thresholds.size()));
+
+	tables->nodes.resize(nodeCount);
+	for (size_t i {}; i < nodeCount; ++i) {
+		const FlatRandomForest::Node &node = nodes[i];
+		Node &quantized = tables->nodes[i];
+		if (node.feature == FlatRandomForest::LeafFeature) {
+			quantized.feature = LeafFeature;
+			quantized.bin = 0;
+			std::memcpy(&quantized.next, &node.value,
+			    sizeof(quantized.next));
+			continue;
+		}
+
+		const std::vector<float> &featureThresholds =
+		    thresholds[node.feature];
+		quantized.feature = static_cast<uint16_t>(node.feature |
+		    (node.missingLessOrEqual ? MissingLessOrEqual : 0));
+		quantized.bin = static_cast<uint16_t>(
+		    std::lower_bound(featureThresholds.cbegin(),
+			featureThresholds.cend(), node.value) -
+		    featureThresholds.cbegin());
+		quantized.next = node.greaterChild;
+	}
+
+	*this = QuantizedRandomForest(tables->nodes.data(),
+	    tables->nodes.size(), tables->roots.data(), tables->roots.size(),
+	    tables->thresholds.data(), tables->thresholdOffsets.data(),
+	    featureCount, tables);
+}
+
+NFIQ2::Prediction::QuantizedRandomForest::QuantizedRandomForest(
+    const Node *nodes, const size_t nodeCount, const uint32_t *roots,
+    const size_t treeCount, const float *thresholds,
+    const uint32_t *thresholdOffsets, const unsigned int featureCount,
+    std::shared_ptr<const void> storage)
+    : storage_ { std::move(storage) }
+    , roots_ { roots }
+    , treeCount_ { treeCount }
+    , nodes_ { nodes }
+    , nodeCount_ { nodeCount }
+    , thresholds_ { thresholds }
+    , thresholdOffsets_ { thresholdOffsets }
+    , featureCount_ { featureCount }
+{
+	static const uint16_t FeatureMask { LeafFeature };
+
+	if (featureCount > MaxFeatureCount) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Too many quantized features (" +
+			std::to_string(featureCount) + ')');
+	}
+
+	/* Thresholds of each feature increase strictly, so bins are exact */
+	if (thresholdOffsets[0] != 0) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Invalid quantized random forest thresholds");
+	}
+	for (unsigned int f {}; f < featureCount; ++f) {
+		const uint32_t first { thresholdOffsets[f] };
+		const uint32_t last { thresholdOffsets[f + 1] };
+		if ((last < first) || (last - first >= MissingBin)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid quantized random forest thresholds of "
+			    "feature " +
+				std::to_string(f));
+		}
+		for (uint32_t t { first }; t < last; ++t) {
+			if (std::isnan(thresholds[t]) ||
+			    ((t > first) &&
+				!(thresholds[t - 1] < thresholds[t]))) {
+				throw NFIQ2::Exception(
+				    NFIQ2::ErrorCode::MachineLearningError,
+				    "Invalid quantized random forest "
+				    "thresholds of feature " +
+					std::to_string(f));
+			}
+		}
+	}
+
+	/* Children follow their parent, so traversals terminate */
+	for (size_t i {}; i < nodeCount; ++i) {
+		const Node &node = nodes[i];
+		if (node.feature == LeafFeature) {
+			continue;
+		}
+		const unsigned int feature { static_cast<unsigned int>(
+			node.feature & FeatureMask) };
+		if ((feature >= featureCount) ||
+		    (node.bin >= thresholdOffsets[feature + 1] -
+			    thresholdOffsets[feature]) ||
+		    (i + 1 >= nodeCount) || (node.next <= i) ||
+		    (node.next >= nodeCount)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid quantized random forest node " +
+				std::to_string(i));
+		}
+	}
+	for (size_t i {}; i < treeCount; ++i) {
+		if (roots[i] >= nodeCount) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Invalid quantized random forest root " +
+				std::to_string(i));
+		}
+	}
+}
+
+unsigned int
+NFIQ2::Prediction::QuantizedRandomForest::getFeatureCount() const
+{
+	return this->featureCount_;
+}
+
+unsigned int
+NFIQ2::Prediction::QuantizedRandomForest::getTreeCount() const
+{
+	return static_cast<unsigned int>(this->treeCount_);
+}
+
+const uint32_t *
+NFIQ2::Prediction::QuantizedRandomForest::getRoots() const
+{
+	return this->roots_;
+}
+
+const NFIQ2::Prediction::QuantizedRandomForest::Node *
+NFIQ2::Prediction::QuantizedRandomForest::getNodes() const
+{
+	return this->nodes_;
+}
+
+size_t
+NFIQ2::Prediction::QuantizedRandomForest::getNodeCount() const
+{
+	return this->nodeCount_;
+}
+
+const float *
+NFIQ2::Prediction::QuantizedRandomForest::getThresholds() const
+{
+	return this->thresholds_;
+}
+
+const uint32_t *
+NFIQ2::Prediction::QuantizedRandomForest::getThresholdOffsets() const
+{
+	return this->thresholdOffsets_;
+}
+
+void
+NFIQ2::Prediction::QuantizedRandomForest::quantize(
+    const float *features, uint16_t *bins) const
+{
+	static const float MissingValue { std::numeric_limits<float>::max() };
+
+	const unsigned int featureCount { this->featureCount_ };
+	for (unsigned int f {}; f < featureCount; ++f) {
+		const float *first { this->thresholds_ +
+			this->thresholdOffsets_[f] };
+		const float *last { this->thresholds_ +
+			this->thresholdOffsets_[f + 1] };
+
+		if (features[f] == MissingValue) {
+			bins[f] = MissingBin;
+		} else if (std::isnan(features[f])) {
+			/* Not less than or equal to any threshold */
+			bins[f] = static_cast<uint16_t>(last - first);
+		} else {
+			bins[f] = static_cast<uint16_t>(
+			    std::lower_bound(first, last, features[f]) -
+			    first);
+		}
+	}
+}
+
+uint32_t
+NFIQ2::Prediction::QuantizedRandomForest::findLeaf(
+    const uint16_t *bins, const uint32_t root) const
+{
+	static const uint16_t FeatureMask { LeafFeature };
+
+	const Node *nodes { this->nodes_ };
+	uint32_t n { root };
+	while (nodes[n].feature != LeafFeature) {
+		const uint16_t feature { nodes[n].feature };
+		const uint16_t bin { bins[feature & FeatureMask] };
+		const bool lessOrEqual { (bin == MissingBin) ?
+			((feature & MissingLessOrEqual) != 0) :
+			(bin <= nodes[n].bin) };
+		n = lessOrEqual ? n + 1 : nodes[n].next;
+	}
+
+	return n;
+}
+
+float
+NFIQ2::Prediction::QuantizedRandomForest::getLeafValue(
+    const uint32_t leaf) const
+{
+	float value {};
+	std::memcpy(&value, &this->nodes_[leaf].next, sizeof(value));
+	return value;
+}
+
+float
+NFIQ2::Prediction::QuantizedRandomForest::predict(const float *features) const
+{
+	std::array<uint16_t, MaxFeatureCount> bins;
+	this->quantize(features, bins.data());
+
+	/* Sum in tree order, in double precision, as OpenCV does */
+	double sum {};
+	for (size_t t {}; t < this->treeCount_; ++t) {
+		sum += this->getLeafValue(
+		    this->findLeaf(bins.data(), this->roots_[t]));
+	}
+
+	return static_cast<float>(sum);
+}
+
+void
+NFIQ2::Prediction::QuantizedRandomForest::predict(const float *features,
+    const size_t sampleCount, float *votes) const
+{
+	static const uint16_t FeatureMask { LeafFeature };
+	/** Most samples passing through a tree before the next tree */
+	static const size_t MaxBlockSize { 128 };
+	/** Bins of a block, 8 KiB of stack */
+	static const size_t BinCapacity { 4096 };
+	/** Samples traversing a tree in lockstep */
+	static const size_t Lanes { 8 };
+
+	const Node *nodes { this->nodes_ };
+	const size_t featureCount { this->featureCount_ };
+	/* At least MaxFeatureCount features fit, so blocks are not empty */
+	const size_t blockSize { std::min(MaxBlockSize,
+	    BinCapacity / std::max<size_t>(featureCount, 1)) };
+
+	std::array<uint16_t, BinCapacity> bins;
+	std::array<double, MaxBlockSize> sums {};
+	for (size_t first {}; first < sampleCount; first += blockSize) {
+		const size_t count { std::min(blockSize, sampleCount - first) };
+
+		/* Each sample is quantized once for all trees */
+		for (size_t i {}; i < count; ++i) {
+			this->quantize(features + ((first + i) * featureCount),
+			    bins.data() + (i * featureCount));
+		}
+		const uint16_t *block { bins.data() };
+		const bool anyMissing { std::find(block,
+					    block + (count * featureCount),
+					    MissingBin) !=
+			block + (count * featureCount) };
+
+		/* Sum in tree order for every sample, as predict() does */
+		std::fill(sums.begin(), sums.begin() + count, 0.0);
+		for (size_t t {}; t < this->treeCount_; ++t) {
+			const uint32_t root { this->roots_[t] };
+			size_t i {};
+
+			/*
+			 * Interleave independent traversals to hide the
+			 * latency of dependent node loads. Rare missing
+			 * features are kept out of this loop.
+			 */
+			for (; !anyMissing && (i + Lanes <= count);
+			     i += Lanes) {
+				std::array<uint32_t, Lanes> n {};
+				n.fill(root);
+				bool active { true };
+				while (active) {
+					active = false;
+					for (size_t l {}; l < Lanes; ++l) {
+						const Node &node = nodes[n[l]];
+						if (node.feature ==
+						    LeafFeature) {
+							continue;
+						}
+						active = true;
+						n[l] = (block[((i + l) *
+							       featureCount) +
+							    (node.feature &
+								FeatureMask)] <=
+							   node.bin) ?
+						    n[l] + 1 :
+						    node.next;
+					}
+				}
+				for (size_t l {}; l < Lanes; ++l) {
+					sums[i + l] += this->getLeafValue(n[l]);
+				}
+			}
+
+			for (; i < count; ++i) {
+				sums[i] += this->getLeafValue(this->findLeaf(
+				    block + (i * featureCount), root));
+			}
+		}
+
+		for (size_t i {}; i < count; ++i) {
+			votes[first + i] = static_cast<float>(sums[i]);
+		}
+	}
+}
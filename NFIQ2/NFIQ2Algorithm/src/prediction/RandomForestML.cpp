@@ -1,6 +1,14 @@
+#include <nfiq2_algorithm.hpp>
 #include <nfiq2_exception.hpp>
 #include <prediction/RandomForestML.h>
+#include <quality_modules/NativeQualityMeasures.h>
 
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+/* Generated from the embedded parameters at build time */
+#include <prediction/RandomForestNodeTables.h>
+
+#include <opencv2/core.hpp>
+#else
 /*
  * If we're embedding parameters, figure out which to embed based on the
  * provided FRCT.
@@ -25,22 +33,33 @@
 #endif /* NFIQ2_EMBEDDED_RANDOM_FOREST_PARAMETERS_FCT */
 #endif /* NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS */
 
+#include <prediction/BinaryRandomForest.h>
+#include <prediction/MappedFile.h>
+
 #include "digestpp.hpp"
+#endif /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <ctime>
+#include <memory>
 #include <numeric> // std::accumulate
+#include <utility>
 
 const char NFIQ2::Identifiers::PredictionAlgorithms::RandomForest[] {
 	"NFIQ2_RandomForest"
 };
+
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
 std::string
-NFIQ2::Prediction::RandomForestML::calculateHashString(const std::string &s)
+NFIQ2::Prediction::RandomForestML::calculateHashString(const void *data,
+    const size_t size)
 {
 	// calculate and compare the hash
 	digestpp::md5 hasher;
 	std::stringstream ss;
 	ss << std::hex
-	   << hasher.absorb((const char *)s.c_str(), s.length()).hexdigest();
+	   << hasher.absorb(static_cast<const char *>(data), size).hexdigest();
 	return ss.str();
 }
 
@@ -54,6 +73,37 @@ NFIQ2::Prediction::RandomForestML::initModule(const std::string &params)
 	// now import data structures
 	m_pTrainedRF = cv::ml::RTrees::create();
 	m_pTrainedRF->read(cv::FileNode(fs["my_random_trees"]));
+
+	// flatten for fast prediction, keeping OpenCV for unsupported models
+	try {
+		m_flatRF = FlatRandomForest(
+		    *m_pTrainedRF, fs["my_random_trees"]);
+		// nodes were copied to the heap anyway, so compact them
+		m_flatRF.quantize();
+	} catch (const NFIQ2::Exception &) {
+		m_flatRF = FlatRandomForest();
+	}
+}
+
+void
+NFIQ2::Prediction::RandomForestML::initModule(const uint8_t *data,
+    const size_t size, std::shared_ptr<const void> storage)
+{
+	if (!BinaryRandomForest::isBinaryRandomForest(data, size)) {
+		initModule(std::string(reinterpret_cast<const char *>(data),
+		    size));
+		return;
+	}
+
+	// evaluated in place, nothing to parse
+	m_pTrainedRF.release();
+	m_flatRF = BinaryRandomForest::read(data, size, std::move(storage));
+	if (m_flatRF.getFeatureCount() != FeatureCount) {
+		m_flatRF = FlatRandomForest();
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Binary random forest does not use " +
+			std::to_string(FeatureCount) + " features");
+	}
 }
 
 #ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
@@ -68,16 +118,66 @@ NFIQ2::Prediction::RandomForestML::joinRFTrainedParamsString()
 	return result;
 }
 #endif
+#endif /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
 
 NFIQ2::Prediction::RandomForestML::RandomForestML() = default;
 
 NFIQ2::Prediction::RandomForestML::~RandomForestML()
 {
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
 	if (!m_pTrainedRF.empty()) {
 		m_pTrainedRF->clear();
 	}
+#endif
+}
+
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+std::string
+NFIQ2::Prediction::RandomForestML::initModule()
+{
+	namespace Tables = RandomForestNodeTables;
+
+	if (Tables::FeatureCount != FeatureCount) {
+		throw Exception(NFIQ2::ErrorCode::InvalidConfiguration,
+		    "Embedded random forest uses " +
+			std::to_string(Tables::FeatureCount) +
+			" features, expected " + std::to_string(FeatureCount));
+	}
+
+	// evaluated in place, nothing to parse
+	const size_t nodeCount { sizeof(Tables::Nodes) /
+		sizeof(Tables::Nodes[0]) };
+	const size_t treeCount { sizeof(Tables::Roots) /
+		sizeof(Tables::Roots[0]) };
+	m_flatRF = FlatRandomForest(Tables::Nodes, nodeCount, Tables::Roots,
+	    treeCount, Tables::FeatureCount);
+	m_flatRF.useQuantized(std::make_shared<const QuantizedRandomForest>(
+	    Tables::QuantizedNodes, nodeCount, Tables::Roots, treeCount,
+	    Tables::Thresholds, Tables::ThresholdOffsets,
+	    Tables::FeatureCount));
+	return Tables::ParameterHash;
 }
 
+std::string
+NFIQ2::Prediction::RandomForestML::initModule(const std::string &,
+    const std::string &)
+{
+	throw Exception(NFIQ2::ErrorCode::InvalidConfiguration,
+	    "Random forest parameters can only be loaded from a file when "
+	    "the library is built without embedded node tables.");
+}
+
+#ifdef __ANDROID__
+std::string
+NFIQ2::Prediction::RandomForestML::initModule(AAssetManager *,
+    const std::string &, const std::string &)
+{
+	throw Exception(NFIQ2::ErrorCode::InvalidConfiguration,
+	    "Random forest parameters can only be loaded from an asset when "
+	    "the library is built without embedded node tables.");
+}
+#endif
+#else /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
 #ifdef NFIQ2_EMBED_RANDOM_FOREST_PARAMETERS
 std::string
 NFIQ2::Prediction::RandomForestML::initModule()
@@ -93,7 +193,7 @@ NFIQ2::Prediction::RandomForestML::initModule()
 		params = "";
 		params.assign((const char *)data.data(), data.size());
 		initModule(params);
-		return calculateHashString(params);
+		return calculateHashString(params.data(), params.size());
 	} catch (const cv::Exception &e) {
 		throw Exception(NFIQ2::ErrorCode::UnknownError, e.msg);
 	} catch (...) {
@@ -106,19 +206,20 @@ std::string
 NFIQ2::Prediction::RandomForestML::initModule(const std::string &fileName,
     const std::string &fileHash)
 {
-	std::ifstream input(fileName);
-	std::string params((std::istreambuf_iterator<char>(input)),
-	    std::istreambuf_iterator<char>());
-	initModule(params);
+	// binary models are evaluated from the mapping, shared between
+	// processes through the page cache
+	const auto file = std::make_shared<const MappedFile>(fileName);
 	// calculate and compare the hash
-	std::string hash = calculateHashString(params);
+	std::string hash = calculateHashString(file->data(), file->size());
 	if (fileHash.compare(hash) != 0) {
-		m_pTrainedRF->clear();
+		m_pTrainedRF.release();
+		m_flatRF = FlatRandomForest();
 		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidConfiguration,
 		    "The trained network could not be initialized! "
 		    "Error: " +
 			hash);
 	}
+	initModule(file->data(), file->size(), file);
 	return hash;
 }
 
@@ -150,209 +251,252 @@ NFIQ2::Prediction::RandomForestML::initModule(AAssetManager *assets,
 	}
 	// reading the file with the asset manager
 	std::stringstream ss;
-	char buffer[BUFSIZ + 1]; // BUFSIZ defined in stdio.h
+	char buffer[BUFSIZ]; // BUFSIZ defined in stdio.h
 	int cnt = AAsset_read(asset, buffer, BUFSIZ);
 	while (cnt > 0 && cnt <= BUFSIZ) {
-		buffer[cnt] = 0; // add terminating '\0'
-		ss << buffer;
+		// binary models may contain '\0'
+		ss.write(buffer, cnt);
 		cnt = AAsset_read(asset, buffer, BUFSIZ);
 	}
 	AAsset_close(asset);
 	// verify the read data and initialize model
-	std::string params = ss.str();
-	if (params.size() == 0) {
+	const auto params = std::make_shared<const std::string>(ss.str());
+	if (params->size() == 0) {
 		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidConfiguration,
 		    "The trained network could not be initialized!"
 		    "Invalid model");
 	}
 	// calculate and compare the hash
-	std::string hash = calculateHashString(params);
+	std::string hash = calculateHashString(params->data(),
+	    params->size());
 	if (fileHash.compare(hash) != 0) {
-		m_pTrainedRF->clear();
+		m_pTrainedRF.release();
+		m_flatRF = FlatRandomForest();
 		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidConfiguration,
 		    "The trained network could not be initialized! "
 		    "Error: " +
 			hash);
 	}
-	initModule(params);
+	initModule(reinterpret_cast<const uint8_t *>(params->data()),
+	    params->size(), params);
 	return hash;
 }
 #endif
+#endif /* NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES */
+
+static_assert(NFIQ2::Prediction::RandomForestML::FeatureCount ==
+	NFIQ2::QualityMeasures::NativeQualityMeasureIndex::Count,
+    "Random forest samples are native quality measure vectors");
+
+const NFIQ2::Prediction::RandomForestML::FeatureOrder &
+NFIQ2::Prediction::RandomForestML::getFeatureOrder()
+{
+	/*
+	 * Native quality measures are laid out in the order of the training
+	 * model currently in use, see NativeQualityMeasureIndex.
+	 */
+	static const FeatureOrder rfFeatureOrder = []() {
+		FeatureOrder order {};
+		for (unsigned int i {}; i < FeatureCount; ++i) {
+			order[i] = QualityMeasures::NativeQualityMeasureVector::
+			    getIdentifier(i);
+		}
+		return order;
+	}();
+
+	return rfFeatureOrder;
+}
+
+namespace {
+/**
+ * Scale the votes of the forest to a unified quality score, without
+ * checking its range.
+ *
+ * @param raw_prediction
+ * Number of trees voting for good quality.
+ * @param max_trees
+ * Number of trees.
+ *
+ * @return
+ * Unified quality score, not decreasing as raw_prediction increases.
+ */
+double
+scaleQualityValue(const float raw_prediction, const float max_trees)
+{
+	/*
+	 * raw_prediction is in the range of 0 to max_trees.
+	 * Scale to range required by ISO/IEC 29794-1 (i.e., 0-100).
+	 */
+	static const float min_quality { 0 };
+	static const float max_quality { 100 };
+	static const float min_trees { 0 };
+	const float scaled_prediction { ((raw_prediction - min_trees) /
+					    (max_trees - min_trees)) *
+		    (max_quality - min_quality) +
+		min_quality };
+
+	return std::floor(scaled_prediction + 0.5);
+}
+}
+
+double
+NFIQ2::Prediction::RandomForestML::computeQualityValue(
+    const float raw_prediction, const float max_trees)
+{
+	static const float min_quality { 0 };
+	static const float max_quality { 100 };
+
+	const double qualityValue = scaleQualityValue(
+	    raw_prediction, max_trees);
+	if ((qualityValue > max_quality) || (qualityValue < min_quality)) {
+		throw NFIQ2::Exception {
+			NFIQ2::ErrorCode::QualityMeasureCalculationError,
+			"Computed quality out of range (" +
+			    std::to_string(qualityValue) + " not in [" +
+			    std::to_string(min_quality) + ", " +
+			    std::to_string(max_quality) + "])"
+		};
+	}
+
+	return qualityValue;
+}
 
 void
-NFIQ2::Prediction::RandomForestML::evaluate(
-    const std::unordered_map<std::string, double> &features,
-    double &qualityValue) const
+NFIQ2::Prediction::RandomForestML::throwIfUntrained() const
+{
+#ifdef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	const bool untrained { m_flatRF.empty() };
+#else
+	// binary models are only evaluated by m_flatRF
+	const bool untrained { m_pTrainedRF.empty() ?
+		!useFlatForest() :
+		(!m_pTrainedRF->isTrained() ||
+		    !m_pTrainedRF->isClassifier()) };
+#endif
+	if (untrained) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::InvalidConfiguration,
+		    "The trained network could not be loaded for "
+		    "prediction!");
+	}
+}
+
+bool
+NFIQ2::Prediction::RandomForestML::useFlatForest() const
 {
-	/**
-	   The following ordering of feature keys is critical to the
-	   correct computation of NFIQ 2 scores. Any modification to this
-	   ordering will result in incorrectly generated NFIQ 2 scores. This is
-	   based on the training model currently in use and may be updated in
-	   the future.
-	*/
-	static const std::vector<std::string> rfFeatureOrder {
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin0,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin1,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin2,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin3,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin4,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin5,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin6,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin7,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin8,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::
-		    Histogram::Bin9,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::Mean,
-		Identifiers::QualityMeasures::FrequencyDomainAnalysis::StdDev,
-
-		Identifiers::QualityMeasures::Minutiae::CountCOM,
-		Identifiers::QualityMeasures::Minutiae::Count,
-		Identifiers::QualityMeasures::Minutiae::PercentImageMean50,
-		Identifiers::QualityMeasures::Minutiae::
-		    PercentOrientationCertainty80,
-
-		Identifiers::QualityMeasures::RegionOfInterest::Mean,
-
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin0,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin1,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin2,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin3,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin4,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin5,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin6,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin7,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin8,
-		Identifiers::QualityMeasures::LocalClarity::Histogram::Bin9,
-		Identifiers::QualityMeasures::LocalClarity::Mean,
-		Identifiers::QualityMeasures::LocalClarity::StdDev,
-
-		Identifiers::QualityMeasures::Contrast::MeanOfBlockMeans,
-		Identifiers::QualityMeasures::Contrast::ImageMean,
-
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin0,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin1,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin2,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin3,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin4,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin5,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin6,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin7,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin8,
-		Identifiers::QualityMeasures::OrientationCertainty::Histogram::
-		    Bin9,
-		Identifiers::QualityMeasures::OrientationCertainty::Mean,
-		Identifiers::QualityMeasures::OrientationCertainty::StdDev,
-
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin0,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin1,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin2,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin3,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin4,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin5,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin6,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin7,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin8,
-		Identifiers::QualityMeasures::OrientationFlow::Histogram::Bin9,
-		Identifiers::QualityMeasures::OrientationFlow::Mean,
-		Identifiers::QualityMeasures::OrientationFlow::StdDev,
-
-		Identifiers::QualityMeasures::RegionOfInterest::CoherenceMean,
-		Identifiers::QualityMeasures::RegionOfInterest::CoherenceSum,
-
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin0,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin1,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin2,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin3,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin4,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin5,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin6,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin7,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin8,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Histogram::
-		    Bin9,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::Mean,
-		Identifiers::QualityMeasures::RidgeValleyUniformity::StdDev
-	};
+	return (!m_flatRF.empty() &&
+	    (m_flatRF.getFeatureCount() == FeatureCount));
+}
 
-	try {
-		if (m_pTrainedRF.empty() || !m_pTrainedRF->isTrained() ||
-		    !m_pTrainedRF->isClassifier()) {
-			throw NFIQ2::Exception(
-			    NFIQ2::ErrorCode::InvalidConfiguration,
-			    "The trained network could not be loaded for "
-			    "prediction!");
+float
+NFIQ2::Prediction::RandomForestML::predictVotes(const float *sample) const
+{
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	if (!useFlatForest()) {
+		const cv::Mat sample_data(1, FeatureCount, CV_32FC1,
+		    (void *)sample);
+		return m_pTrainedRF->predict(sample_data, cv::noArray(),
+		    cv::ml::StatModel::RAW_OUTPUT);
+	}
+#endif
+
+	return m_flatRF.predict(sample);
+}
+
+void
+NFIQ2::Prediction::RandomForestML::predictVotes(const float *samples,
+    const size_t sampleCount, float *votes) const
+{
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	if (!useFlatForest()) {
+		const cv::Mat sample_data(static_cast<int>(sampleCount),
+		    FeatureCount, CV_32FC1, (void *)samples);
+		cv::Mat results {};
+		m_pTrainedRF->predict(sample_data, results,
+		    cv::ml::StatModel::RAW_OUTPUT);
+		for (size_t i {}; i < sampleCount; ++i) {
+			votes[i] = results.at<float>(static_cast<int>(i));
 		}
+		return;
+	}
+#endif
+
+	m_flatRF.predict(samples, sampleCount, votes);
+}
+
+float
+NFIQ2::Prediction::RandomForestML::getTreeCount() const
+{
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+	if (!useFlatForest()) {
+		return static_cast<float>(m_pTrainedRF->getRoots().size());
+	}
+#endif
+
+	return static_cast<float>(m_flatRF.getTreeCount());
+}
+
+void
+NFIQ2::Prediction::RandomForestML::evaluate(const double *features,
+    const size_t sampleCount, double *qualityValues) const
+{
+	if (sampleCount == 0) {
+		return;
+	}
+
+	try {
+		throwIfUntrained();
 
 		// copy data to structure
-		cv::Mat sample_data = cv::Mat(1, rfFeatureOrder.size(),
-		    CV_32FC1);
+		const std::vector<float> samples(
+		    features, features + (sampleCount * FeatureCount));
 
-		for (unsigned int i { 0 }; i < rfFeatureOrder.size(); ++i) {
-			sample_data.at<float>(0, i) = features.at(
-			    rfFeatureOrder[i]);
+		std::vector<float> raw_predictions(sampleCount);
+		predictVotes(samples.data(), sampleCount,
+		    raw_predictions.data());
+
+		const float max_trees { getTreeCount() };
+		for (size_t i {}; i < sampleCount; ++i) {
+			qualityValues[i] = computeQualityValue(
+			    raw_predictions[i], max_trees);
 		}
+	} catch (const cv::Exception &e) {
+		throw Exception(NFIQ2::ErrorCode::MachineLearningError, e.msg);
+	}
+}
+
+NFIQ2::QualityThresholdResult
+NFIQ2::Prediction::RandomForestML::meetsQualityThreshold(
+    const double *features, const unsigned int threshold) const
+{
+	try {
+		throwIfUntrained();
+
+		// copy data to structure
+		std::array<float, FeatureCount> sample {};
+		std::copy(features, features + FeatureCount, sample.begin());
+
+		const float max_trees { getTreeCount() };
+		const auto accept = [&](const float raw_prediction) {
+			return scaleQualityValue(raw_prediction, max_trees) >=
+			    threshold;
+		};
 
-		const float raw_prediction = m_pTrainedRF->predict(sample_data,
-		    cv::noArray(), cv::ml::StatModel::RAW_OUTPUT);
-
-		/*
-		 * raw_prediction is in the range of 0 to max_trees.
-		 * Scale to range required by ISO/IEC 29794-1 (i.e., 0-100).
-		 */
-		static const float min_quality { 0 };
-		static const float max_quality { 100 };
-		static const float min_trees { 0 };
-		const float max_trees { static_cast<float>(
-		    m_pTrainedRF->getRoots().size()) };
-		const float scaled_prediction { ((raw_prediction - min_trees) /
-						    (max_trees - min_trees)) *
-			    (max_quality - min_quality) +
-			min_quality };
-
-		qualityValue = std::floor(scaled_prediction + 0.5);
-		if ((qualityValue > max_quality) ||
-		    (qualityValue < min_quality)) {
-			throw Exception {
-				ErrorCode::QualityMeasureCalculationError,
-				"Computed quality out of range (" +
-				    std::to_string(qualityValue) + " not in [" +
-				    std::to_string(min_quality) + ", " +
-				    std::to_string(max_quality) + "])"
-			};
+		QualityThresholdResult result {};
+		result.treeCount = static_cast<unsigned int>(max_trees);
+#ifndef NFIQ2_EMBED_RANDOM_FOREST_NODE_TABLES
+		if (!useFlatForest()) {
+			// OpenCV always evaluates every tree
+			result.meetsThreshold = accept(
+			    predictVotes(sample.data()));
+			result.treesEvaluated = result.treeCount;
+			return result;
 		}
+#endif
+		result.meetsThreshold = m_flatRF.decide(sample.data(), accept,
+		    result.treesEvaluated);
+		return result;
 	} catch (const cv::Exception &e) {
 		throw Exception(NFIQ2::ErrorCode::MachineLearningError, e.msg);
-	} catch (const std::out_of_range &e) {
-		throw Exception(
-		    NFIQ2::ErrorCode::QualityMeasureCalculationError, e.what());
 	}
 }
 
@@ -0,0 +1,440 @@
+/*
+ * Micro-benchmark and equivalence harness of random forest evaluation.
+ *
+ * Replays native quality measures stored in a verbose NFIQ 2 CSV (e.g.,
+ * conformance/conformance_expected_output-v2.3.0.csv) through every way
+ * the library can evaluate the random forest, reporting the time per
+ * prediction of each. OpenCV is the reference: votes of the flattened
+ * forest, evaluated from its float nodes, of its quantized copy, and of
+ * the forest written as a binary model and read back must match OpenCV
+ * votes, as measured and with some features missing.
+ * Scores and decisions of RandomForestML must match unified quality
+ * scores computed from OpenCV votes, row by row. Quality scores recorded
+ * in the CSV are compared too, but mismatches are only reported, since
+ * the CSV rounds native quality measures.
+ *
+ * Usage: nfiq2-rf-benchmark <model info> <verbose CSV> [repetitions
+ *     [threshold]]
+ */
+
+#include <nfiq2_algorithm.hpp>
+#include <nfiq2_exception.hpp>
+#include <nfiq2_modelinfo.hpp>
+#include <prediction/BinaryRandomForest.h>
+#include <prediction/FlatRandomForest.h>
+#include <prediction/QuantizedRandomForest.h>
+#include <prediction/RandomForestML.h>
+
+#include <opencv2/ml.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+/** Native quality measures and scores replayed */
+struct Samples {
+	/** RandomForestML::FeatureCount measures per sample */
+	std::vector<double> features {};
+	/** Quality score recorded for each sample */
+	std::vector<unsigned int> scores {};
+};
+
+/** @return Fields of a CSV line, without quotes */
+std::vector<std::string>
+splitCSVLine(const std::string &line)
+{
+	std::vector<std::string> fields(1);
+	bool quoted { false };
+	for (const char c : line) {
+		if (c == '"') {
+			quoted = !quoted;
+		} else if ((c == ',') && !quoted) {
+			fields.emplace_back();
+		} else if ((c != '\r') && (c != '\n')) {
+			fields.back() += c;
+		}
+	}
+	return fields;
+}
+
+/**
+ * @return
+ * Samples of `path` with a quality score and all native quality measures.
+ *
+ * @throw NFIQ2::Exception
+ * The file cannot be read or lacks native quality measures.
+ */
+Samples
+readSamples(const std::string &path)
+{
+	std::ifstream in(path);
+	std::string line {};
+	if (!std::getline(in, line)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::CannotReadFromFile,
+		    "Could not read " + path);
+	}
+
+	std::unordered_map<std::string, size_t> columns {};
+	const std::vector<std::string> header { splitCSVLine(line) };
+	for (size_t i {}; i < header.size(); ++i) {
+		columns[header[i]] = i;
+	}
+
+	const auto findColumn = [&](const std::string &name) {
+		const auto it = columns.find(name);
+		if (it == columns.cend()) {
+			throw NFIQ2::Exception(NFIQ2::ErrorCode::BadArguments,
+			    path + " has no column " + name +
+				" (not created with --verbose?)");
+		}
+		return it->second;
+	};
+	const size_t scoreColumn { findColumn("QualityScore") };
+	std::vector<size_t> featureColumns {};
+	for (const auto &id :
+	    NFIQ2::Prediction::RandomForestML::getFeatureOrder()) {
+		featureColumns.push_back(findColumn(id));
+	}
+
+	Samples samples {};
+	std::vector<double> features(featureColumns.size());
+	while (std::getline(in, line)) {
+		const std::vector<std::string> fields { splitCSVLine(line) };
+		if ((fields.size() != header.size()) ||
+		    (fields[scoreColumn] == "NA")) {
+			continue;
+		}
+
+		try {
+			for (size_t i {}; i < featureColumns.size(); ++i) {
+				features[i] = std::stod(
+				    fields[featureColumns[i]]);
+			}
+			samples.scores.push_back(static_cast<unsigned int>(
+			    std::stoul(fields[scoreColumn])));
+		} catch (const std::exception &) {
+			/* Measures not computed */
+			continue;
+		}
+		samples.features.insert(samples.features.end(),
+		    features.cbegin(), features.cend());
+	}
+
+	return samples;
+}
+
+/** @return Nanoseconds per prediction of `repetitions` runs of `run` */
+template <typename Run>
+double
+timePerPrediction(const unsigned int repetitions, const size_t predictions,
+    const Run &run)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned int r {}; r < repetitions; ++r) {
+		run();
+	}
+	const std::chrono::duration<double, std::nano> elapsed {
+		std::chrono::steady_clock::now() - start
+	};
+
+	return elapsed.count() /
+	    (static_cast<double>(repetitions) *
+		static_cast<double>(predictions));
+}
+
+/** Print one line of results */
+void
+report(const std::string &evaluator, const double ns,
+    const size_t mismatches, const std::string &note = {})
+{
+	std::cout << std::left << std::setw(52) << evaluator << std::right
+		  << std::setw(12) << std::fixed << std::setprecision(1)
+		  << ns << " ns  " << std::setw(6) << mismatches
+		  << " mismatches" << note << "\n";
+}
+
+/** @return Number of entries of `values` that differ from `reference` */
+template <typename T>
+size_t
+countMismatches(const std::vector<T> &reference, const std::vector<T> &values)
+{
+	size_t mismatches {};
+	for (size_t i {}; i < reference.size(); ++i) {
+		mismatches += (values[i] != reference[i]);
+	}
+	return mismatches;
+}
+
+/**
+ * @return
+ * Votes of OpenCV for samples of RandomForestML::FeatureCount features,
+ * timed over `repetitions` runs.
+ */
+std::vector<float>
+predictReference(const cv::ml::RTrees &trees,
+    const std::vector<float> &features, const unsigned int repetitions,
+    const std::string &evaluator)
+{
+	static const unsigned int FeatureCount {
+		NFIQ2::Prediction::RandomForestML::FeatureCount
+	};
+	const size_t count { features.size() / FeatureCount };
+
+	std::vector<float> votes(count);
+	const double ns { timePerPrediction(repetitions, count, [&]() {
+		for (size_t i {}; i < count; ++i) {
+			const cv::Mat sample(1, FeatureCount, CV_32FC1,
+			    (void *)(features.data() + (i * FeatureCount)));
+			votes[i] = trees.predict(sample, cv::noArray(),
+			    cv::ml::StatModel::RAW_OUTPUT);
+		}
+	}) };
+	report(evaluator, ns, 0, " (reference)");
+
+	return votes;
+}
+
+/**
+ * @brief
+ * Time predictions of `forest`, one sample at a time and in batch, and
+ * compare its votes to `reference`.
+ *
+ * @return
+ * Number of votes of both that differ from `reference`.
+ */
+template <typename Forest>
+size_t
+benchmarkForest(const std::string &evaluator, const Forest &forest,
+    const std::vector<float> &features, const std::vector<float> &reference,
+    const unsigned int repetitions)
+{
+	const unsigned int featureCount { forest.getFeatureCount() };
+	const size_t count { reference.size() };
+
+	std::vector<float> votes(count);
+	const double singleNs { timePerPrediction(repetitions, count, [&]() {
+		for (size_t i {}; i < count; ++i) {
+			votes[i] = forest.predict(
+			    features.data() + (i * featureCount));
+		}
+	}) };
+	const size_t singleMismatches { countMismatches(reference, votes) };
+	report(evaluator + "::predict", singleNs, singleMismatches);
+
+	std::vector<float> batchVotes(count);
+	const double batchNs { timePerPrediction(repetitions, count, [&]() {
+		forest.predict(features.data(), count, batchVotes.data());
+	}) };
+	const size_t batchMismatches { countMismatches(reference, batchVotes) };
+	report(evaluator + "::predict (batch)", batchNs, batchMismatches);
+
+	return singleMismatches + batchMismatches;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+	if ((argc < 3) || (argc > 5)) {
+		std::cerr << "Usage: " << argv[0]
+			  << " <model info> <verbose CSV> [repetitions "
+			     "[threshold]]\n";
+		return EXIT_FAILURE;
+	}
+	const unsigned int repetitions { (argc > 3) ?
+		    static_cast<unsigned int>(std::stoul(argv[3])) :
+		    100 };
+	const unsigned int threshold { (argc > 4) ?
+		    static_cast<unsigned int>(std::stoul(argv[4])) :
+		    40 };
+
+	using NFIQ2::Prediction::RandomForestML;
+	static const unsigned int FeatureCount { RandomForestML::FeatureCount };
+
+	size_t totalMismatches {};
+	try {
+		const NFIQ2::ModelInfo modelInfo(argv[1]);
+		RandomForestML forest {};
+		forest.initModule(
+		    modelInfo.getModelPath(), modelInfo.getModelHash());
+
+		/* Alternative evaluators, from the same parameters */
+		cv::FileStorage fs(modelInfo.getModelPath(),
+		    cv::FileStorage::READ | cv::FileStorage::FORMAT_YAML);
+		if (!fs.isOpened()) {
+			std::cerr << "Could not read "
+				  << modelInfo.getModelPath()
+				  << " as OpenCV YAML\n";
+			return EXIT_FAILURE;
+		}
+		const cv::Ptr<cv::ml::RTrees> trees = cv::ml::RTrees::create();
+		trees->read(cv::FileNode(fs["my_random_trees"]));
+		/* Evaluated from float nodes, as binary and embedded models */
+		const NFIQ2::Prediction::FlatRandomForest flat(
+		    *trees, fs["my_random_trees"]);
+		const NFIQ2::Prediction::QuantizedRandomForest quantized(flat);
+		/* Evaluated from stored quantized nodes, as binary models */
+		std::ostringstream binaryModel {};
+		NFIQ2::Prediction::BinaryRandomForest::write(binaryModel, flat);
+		const std::string binaryBytes { binaryModel.str() };
+		// copied to 8-byte words, aligned like a mapped file
+		const auto binaryStorage =
+		    std::make_shared<std::vector<uint64_t>>(
+			(binaryBytes.size() + sizeof(uint64_t) - 1) /
+			sizeof(uint64_t));
+		std::memcpy(binaryStorage->data(), binaryBytes.data(),
+		    binaryBytes.size());
+		const NFIQ2::Prediction::FlatRandomForest binary {
+			NFIQ2::Prediction::BinaryRandomForest::read(
+			    reinterpret_cast<const uint8_t *>(
+				binaryStorage->data()),
+			    binaryBytes.size(), binaryStorage)
+		};
+
+		const Samples samples { readSamples(argv[2]) };
+		const size_t count { samples.scores.size() };
+		if (count == 0) {
+			std::cerr << "No samples with native quality "
+				     "measures in "
+				  << argv[2] << "\n";
+			return EXIT_FAILURE;
+		}
+		const std::vector<float> features(
+		    samples.features.cbegin(), samples.features.cend());
+		std::cout << count << " samples, " << repetitions
+			  << " repetitions, " << flat.getTreeCount()
+			  << " trees\n\n";
+
+		const std::vector<float> votes { predictReference(
+		    *trees, features, repetitions, "cv::ml::RTrees::predict") };
+		totalMismatches += benchmarkForest("FlatRandomForest", flat,
+		    features, votes, repetitions);
+		totalMismatches += benchmarkForest("QuantizedRandomForest",
+		    quantized, features, votes, repetitions);
+		totalMismatches += benchmarkForest("BinaryRandomForest",
+		    binary, features, votes, repetitions);
+
+		/*
+		 * Measures are rarely missing in practice, so mark a few as
+		 * missing in every sample to exercise those branches.
+		 */
+		std::vector<float> missingFeatures(features);
+		for (size_t i {}; i < count; ++i) {
+			for (unsigned int m {}; m < 1 + (i % 3); ++m) {
+				missingFeatures[(i * FeatureCount) +
+				    (((i * 7) + (m * 23)) % FeatureCount)] =
+				    std::numeric_limits<float>::max();
+			}
+		}
+		std::cout << "\nWith 1 to 3 missing measures per sample:\n";
+		const std::vector<float> missingVotes { predictReference(*trees,
+		    missingFeatures, repetitions, "cv::ml::RTrees::predict") };
+		totalMismatches += benchmarkForest("FlatRandomForest", flat,
+		    missingFeatures, missingVotes, repetitions);
+		totalMismatches += benchmarkForest("QuantizedRandomForest",
+		    quantized, missingFeatures, missingVotes, repetitions);
+		totalMismatches += benchmarkForest("BinaryRandomForest",
+		    binary, missingFeatures, missingVotes, repetitions);
+
+		/* Reference scores, from OpenCV votes */
+		const float treeCount { static_cast<float>(
+		    flat.getTreeCount()) };
+		std::vector<double> scores(count);
+		for (size_t i {}; i < count; ++i) {
+			scores[i] = RandomForestML::computeQualityValue(
+			    votes[i], treeCount);
+		}
+		std::cout << "\nCompared to scores of OpenCV votes:\n";
+
+		std::vector<double> evaluateScores(count);
+		const double evaluateNs { timePerPrediction(repetitions, count,
+		    [&]() {
+			    for (size_t i {}; i < count; ++i) {
+				    forest.evaluate(samples.features.data() +
+					    (i * FeatureCount),
+					1, &evaluateScores[i]);
+			    }
+		    }) };
+		const size_t evaluateMismatches { countMismatches(
+		    scores, evaluateScores) };
+		report("RandomForestML::evaluate", evaluateNs,
+		    evaluateMismatches);
+
+		std::vector<double> batchScores(count);
+		const double evaluateBatchNs { timePerPrediction(repetitions,
+		    count, [&]() {
+			    forest.evaluate(samples.features.data(), count,
+				batchScores.data());
+		    }) };
+		const size_t evaluateBatchMismatches { countMismatches(
+		    scores, batchScores) };
+		report("RandomForestML::evaluate (batch)", evaluateBatchNs,
+		    evaluateBatchMismatches);
+
+		std::vector<NFIQ2::QualityThresholdResult> decisions(count);
+		const double thresholdNs { timePerPrediction(repetitions,
+		    count, [&]() {
+			    for (size_t i {}; i < count; ++i) {
+				    decisions[i] = forest.meetsQualityThreshold(
+					samples.features.data() +
+					    (i * FeatureCount),
+					threshold);
+			    }
+		    }) };
+		size_t thresholdMismatches {};
+		double treesEvaluated {};
+		for (size_t i {}; i < count; ++i) {
+			thresholdMismatches += (decisions[i].meetsThreshold !=
+			    (scores[i] >= threshold));
+			treesEvaluated += decisions[i].treesEvaluated;
+		}
+		std::ostringstream thresholdNote {};
+		thresholdNote << std::fixed << std::setprecision(1) << " ("
+			      << (treesEvaluated / static_cast<double>(count))
+			      << " trees on average)";
+		report("RandomForestML::meetsQualityThreshold(" +
+			std::to_string(threshold) + ")",
+		    thresholdNs, thresholdMismatches, thresholdNote.str());
+
+		totalMismatches += evaluateMismatches +
+		    evaluateBatchMismatches + thresholdMismatches;
+
+		size_t recordedMismatches {};
+		for (size_t i {}; i < count; ++i) {
+			recordedMismatches += (static_cast<unsigned int>(
+						   scores[i]) !=
+			    samples.scores[i]);
+		}
+		std::cout << "\n"
+			  << recordedMismatches << " of " << count
+			  << " scores differ from " << argv[2]
+			  << " (native quality measures there are "
+			     "rounded)\n";
+	} catch (const NFIQ2::Exception &e) {
+		std::cerr << "Could not benchmark random forest: " << e.what()
+			  << "\n";
+		return EXIT_FAILURE;
+	} catch (const cv::Exception &e) {
+		std::cerr << "Could not read random forest parameters: "
+			  << e.msg << "\n";
+		return EXIT_FAILURE;
+	}
+
+	if (totalMismatches != 0) {
+		std::cerr << "Evaluators disagree on " << totalMismatches
+			  << " predictions\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
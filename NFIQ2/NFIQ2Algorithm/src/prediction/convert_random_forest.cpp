@@ -0,0 +1,82 @@
+/*
+ * Converter of YAML random forest parameters to binary random forests.
+ *
+ * Reads OpenCV random forest parameters as used by NFIQ 2 and writes them
+ * in the format of BinaryRandomForest, then prints the hash to record in
+ * the model information file referencing the binary model.
+ *
+ * Usage: nfiq2-rf-convert <YAML parameters> <binary output>
+ */
+
+#include <nfiq2_exception.hpp>
+#include <prediction/BinaryRandomForest.h>
+#include <prediction/FlatRandomForest.h>
+#include <prediction/RandomForestML.h>
+
+#include "digestpp.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int
+main(int argc, char *argv[])
+{
+	if (argc != 3) {
+		std::cerr << "Usage: " << argv[0]
+			  << " <YAML parameters> <binary output>\n";
+		return EXIT_FAILURE;
+	}
+
+	try {
+		cv::FileStorage fs(argv[1],
+		    cv::FileStorage::READ | cv::FileStorage::FORMAT_YAML);
+		if (!fs.isOpened()) {
+			std::cerr << "Could not read " << argv[1] << "\n";
+			return EXIT_FAILURE;
+		}
+		const cv::Ptr<cv::ml::RTrees> trees =
+		    cv::ml::RTrees::create();
+		trees->read(cv::FileNode(fs["my_random_trees"]));
+
+		// binary models have no OpenCV fallback
+		const NFIQ2::Prediction::FlatRandomForest forest(
+		    *trees, fs["my_random_trees"]);
+		if (forest.empty() ||
+		    (forest.getFeatureCount() !=
+			NFIQ2::Prediction::RandomForestML::FeatureCount)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Random forest does not use the expected "
+			    "native quality measures");
+		}
+
+		std::ostringstream model {};
+		NFIQ2::Prediction::BinaryRandomForest::write(model, forest);
+		const std::string bytes { model.str() };
+
+		std::ofstream out(argv[2], std::ios::binary);
+		out.write(bytes.data(), static_cast<std::streamsize>(
+		    bytes.size()));
+		out.close();
+		if (!out) {
+			std::cerr << "Could not write " << argv[2] << "\n";
+			return EXIT_FAILURE;
+		}
+
+		digestpp::md5 hasher {};
+		hasher.absorb(bytes.data(), bytes.size());
+		std::cout << "Hash = " << hasher.hexdigest() << "\n";
+	} catch (const NFIQ2::Exception &e) {
+		std::cerr << "Could not convert random forest: " << e.what()
+			  << "\n";
+		return EXIT_FAILURE;
+	} catch (const cv::Exception &e) {
+		std::cerr << "Could not read random forest parameters: "
+			  << e.msg << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*
+ * Build-time generator of prediction/RandomForestNodeTables.h.
+ *
+ * Decodes the embedded random forest parameters the same way
+ * RandomForestML::initModule() does, flattens the forest with
+ * FlatRandomForest and writes its nodes, and those of the quantized
+ * forest, as constant tables, so that the library can evaluate the
+ * forest in place without parsing anything at runtime.
+ *
+ * Usage: generate_node_tables <output header>
+ */
+
+#include <nfiq2_data.hpp>
+#include <nfiq2_exception.hpp>
+#include <prediction/FlatRandomForest.h>
+#include <prediction/QuantizedRandomForest.h>
+#include <prediction/RandomForestML.h>
+#include <prediction/RandomForestTrainedParams.h>
+
+#include "digestpp.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+/** @return `value` as a C++ float literal that reads back exactly */
+std::string
+floatLiteral(const float value)
+{
+	if (!std::isfinite(value)) {
+		throw NFIQ2::Exception(NFIQ2::ErrorCode::MachineLearningError,
+		    "Random forest contains a non-finite value");
+	}
+
+	char buffer[32] {};
+	std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+	std::string literal { buffer };
+	if (literal.find_first_of(".e") == std::string::npos) {
+		literal += ".0";
+	}
+	return literal + 'f';
+}
+
+void
+writeTables(std::ostream &out,
+    const NFIQ2::Prediction::FlatRandomForest &forest, const std::string &hash)
+{
+	// throws if the forest cannot be quantized
+	const NFIQ2::Prediction::QuantizedRandomForest quantized { forest };
+
+	out << "/* Generated by generate_node_tables from the embedded random "
+	       "forest\n * parameters. Do not edit. */\n\n"
+	       "#ifndef NFIQ2_PREDICTION_RANDOMFORESTNODETABLES_H_\n"
+	       "#define NFIQ2_PREDICTION_RANDOMFORESTNODETABLES_H_\n\n"
+	       "#include <prediction/FlatRandomForest.h>\n"
+	       "#include <prediction/QuantizedRandomForest.h>\n\n"
+	       "#include <cstdint>\n\n"
+	       "namespace NFIQ2 { namespace Prediction {\n"
+	       "namespace RandomForestNodeTables {\n\n";
+
+	out << "/** MD5 of the parameters the tables were generated from */\n"
+	       "constexpr char ParameterHash[] { \""
+	    << hash << "\" };\n\n";
+
+	out << "/** Number of features of a sample */\n"
+	       "constexpr unsigned int FeatureCount { "
+	    << forest.getFeatureCount() << " };\n\n";
+
+	out << "/** Index of the root node of each tree */\n"
+	       "constexpr uint32_t Roots[] {\n";
+	for (unsigned int i {}; i < forest.getTreeCount(); ++i) {
+		out << '\t' << forest.getRoots()[i] << ",\n";
+	}
+	out << "};\n\n";
+
+	out << "/** Nodes of all trees, see FlatRandomForest */\n"
+	       "constexpr FlatRandomForest::Node Nodes[] {\n";
+	for (size_t i {}; i < forest.getNodeCount(); ++i) {
+		const NFIQ2::Prediction::FlatRandomForest::Node &node =
+		    forest.getNodes()[i];
+		out << "\t{ " << floatLiteral(node.value) << ", "
+		    << node.greaterChild << ", " << node.feature << ", "
+		    << static_cast<unsigned int>(node.missingLessOrEqual)
+		    << ", 0 },\n";
+	}
+	out << "};\n\n";
+
+	out << "/** Offset of the thresholds of each feature in Thresholds, "
+	       "and their\n * total number */\n"
+	       "constexpr uint32_t ThresholdOffsets[] {\n";
+	for (unsigned int f {}; f <= quantized.getFeatureCount(); ++f) {
+		out << '\t' << quantized.getThresholdOffsets()[f] << ",\n";
+	}
+	out << "};\n\n";
+
+	out << "/** Thresholds of each feature, see QuantizedRandomForest */\n"
+	       "constexpr float Thresholds[] {\n";
+	for (uint32_t t {};
+	     t < quantized.getThresholdOffsets()[quantized.getFeatureCount()];
+	     ++t) {
+		out << '\t' << floatLiteral(quantized.getThresholds()[t])
+		    << ",\n";
+	}
+	out << "};\n\n";
+
+	out << "/** Quantized nodes of all trees, see "
+	       "QuantizedRandomForest */\n"
+	       "constexpr QuantizedRandomForest::Node QuantizedNodes[] {\n";
+	for (size_t i {}; i < quantized.getNodeCount(); ++i) {
+		const NFIQ2::Prediction::QuantizedRandomForest::Node &node =
+		    quantized.getNodes()[i];
+		out << "\t{ " << node.feature << ", " << node.bin << ", "
+		    << node.next << "u },\n";
+	}
+	out << "};\n\n";
+
+	out << "}\n}}\n\n"
+	       "#endif /* NFIQ2_PREDICTION_RANDOMFORESTNODETABLES_H_ */\n";
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+	if (argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <output header>\n";
+		return EXIT_FAILURE;
+	}
+
+	try {
+		std::string params {};
+		for (const auto &chunk : g_strRandomForestTrainedParams) {
+			params.append(chunk);
+		}
+		NFIQ2::Data data {};
+		data.fromBase64String(params);
+		params.assign((const char *)data.data(), data.size());
+
+		digestpp::md5 hasher {};
+		hasher.absorb(params.c_str(), params.length());
+		const std::string hash { hasher.hexdigest() };
+
+		cv::FileStorage fs(params,
+		    cv::FileStorage::READ | cv::FileStorage::MEMORY |
+			cv::FileStorage::FORMAT_YAML);
+		const cv::Ptr<cv::ml::RTrees> trees =
+		    cv::ml::RTrees::create();
+		trees->read(cv::FileNode(fs["my_random_trees"]));
+
+		// no OpenCV fallback in builds using the tables
+		const NFIQ2::Prediction::FlatRandomForest forest(
+		    *trees, fs["my_random_trees"]);
+		if (forest.empty() ||
+		    (forest.getFeatureCount() !=
+			NFIQ2::Prediction::RandomForestML::FeatureCount)) {
+			throw NFIQ2::Exception(
+			    NFIQ2::ErrorCode::MachineLearningError,
+			    "Random forest does not use the expected "
+			    "native quality measures");
+		}
+
+		std::ofstream out(argv[1]);
+		writeTables(out, forest, hash);
+		out.close();
+		if (!out) {
+			std::cerr << "Could not write " << argv[1] << "\n";
+			return EXIT_FAILURE;
+		}
+	} catch (const NFIQ2::Exception &e) {
+		std::cerr << "Could not generate random forest node tables: "
+			  << e.what() << "\n";
+		return EXIT_FAILURE;
+	} catch (const cv::Exception &e) {
+		std::cerr << "Could not read random forest parameters: "
+			  << e.msg << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
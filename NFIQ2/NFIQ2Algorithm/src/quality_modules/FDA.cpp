@@ -4,6 +4,8 @@
 #include <quality_modules/FDA.h>
 #include <quality_modules/common_functions.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <sstream>
 
@@ -41,13 +43,23 @@ const char
 	    "FDA_Bin10_StdDev"
     };
 
+namespace {
+/** Largest ridge signature transformed, in samples */
+const int MaxRidgeSignatureSize { 64 };
+}
+
 double fda(const cv::Mat &block, const double orientation, const int v1sz_x,
     const int v1sz_y, const bool padFlag);
 
 NFIQ2::QualityMeasures::FDA::FDA(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
+    : FDA(FeatureContext { fingerprintImage })
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+}
+
+NFIQ2::QualityMeasures::FDA::FDA(const FeatureContext &context)
+{
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::FDA::~FDA() = default;
@@ -86,11 +98,14 @@ NFIQ2::QualityMeasures::FDA::getName() const
 	    FrequencyDomainAnalysis;
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::FDA::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -102,7 +117,8 @@ NFIQ2::QualityMeasures::FDA::computeFeatureData(
 
 	// get matrix from fingerprint image
 	cv::Mat img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-	    CV_8UC1, (void *)fingerprintImage.data());
+	    CV_8UC1, (void *)fingerprintImage.pixels,
+	    fingerprintImage.stride);
 
 	// ----------------------------
 	// compute Fda (taken from Rvu)
@@ -112,88 +128,57 @@ NFIQ2::QualityMeasures::FDA::computeFeatureData(
 	try {
 		timer.start();
 
-		cv::Mat maskim;
 		const int blksize = this->blocksize;
 		const int v1sz_x = this->slantedBlockSizeX;
 		const int v1sz_y = this->slantedBlockSizeY;
 
-		assert((blksize > 0) && (this->threshold > 0));
-
-		ridgesegment(img, blksize, this->threshold, cv::noArray(),
-		    maskim, cv::noArray());
+		assert(blksize > 0);
 
-		int rows = img.rows;
-		int cols = img.cols;
-		double blk = static_cast<double>(blksize);
-
-		double sumSQ = static_cast<double>(
-		    (v1sz_x * v1sz_x) + (v1sz_y * v1sz_y));
-		double eblksz = ceil(
-		    sqrt(sumSQ)); // block size for extraction of slanted block
-		double diff = (eblksz - blk);
-		int blkoffset = static_cast<int>(
-		    ceil(diff / 2)); // overlapping border
-
-		int mapRows = static_cast<int>(
-		    (static_cast<double>(rows) - diff) / blk);
-		int mapCols = static_cast<int>(
-		    (static_cast<double>(cols) - diff) / blk);
+		const int blkoffset = context.getBlockOffset();
+		const int mapRows = context.getBlockRows();
+		const int mapCols = context.getBlockCols();
 
 		cv::Mat fdas = cv::Mat::zeros(mapRows, mapCols, CV_64F);
-		cv::Mat blkorient = cv::Mat::zeros(mapRows, mapCols, CV_64F);
-		cv::Mat im_roi, blkwim;
-		cv::Mat maskB1;
-		double cova, covb, covc;
-
-		std::vector<double> dataVector;
-		dataVector.reserve(mapRows * mapCols);
 
 		// Image processed NOT from beg to end but with a border around
 		// - can't be vectorized:(
-		int br = 0;
-		int bc = 0;
-		for (int r = blkoffset; r < rows - (blksize + blkoffset - 1);
-		     r += blksize) {
-			for (int c = blkoffset;
-			     c < cols - (blksize + blkoffset - 1);
-			     c += blksize) {
-				im_roi = img(cv::Range(r,
-						 cv::min(r + blksize,
-						     img.rows)),
-				    cv::Range(c,
-					cv::min(c + blksize, img.cols)));
-				maskB1 = maskim(cv::Range(r,
-						    cv::min(r + blksize,
-							maskim.rows)),
-				    cv::Range(c,
-					cv::min(c + blksize, maskim.cols)));
-				uint8_t mask = allfun(maskB1);
-				if (mask == 1) {
-					covcoef(im_roi, cova, covb, covc,
-					    CENTERED_DIFFERENCES);
-
-					// ridge ORIENT local
-					blkorient.at<double>(br,
-					    bc) = ridgeorient(cova, covb, covc);
+		// Rows of blocks may be processed concurrently, their values
+		// are gathered in row order.
+		std::vector<std::vector<double>> rowData(
+		    static_cast<size_t>(std::max(mapRows, 0)));
+		// before the loop, so that its tasks only read orientations
+		context.computeBlockOrientations();
+		context.parallelFor(mapRows, [&](int br) {
+			const int r = blkoffset + (br * blksize);
+			std::vector<double> &rowDataVector = rowData[br];
+			for (int bc = 0; bc < mapCols; bc++) {
+				const int c = blkoffset + (bc * blksize);
+				const FeatureContext::BlockOrientation &block =
+				    context.getBlockOrientation(br, bc);
+				if (block.foreground == 1) {
 					// overlapping windows (border =
 					// blkoffset)
-					blkwim = img(cv::Range(r - blkoffset,
-							 cv::min(r + blksize +
-								 blkoffset,
-							     img.rows)),
+					const cv::Mat blkwim = img(
+					    cv::Range(r - blkoffset,
+						cv::min(r + blksize + blkoffset,
+						    img.rows)),
 					    cv::Range(c - blkoffset,
 						cv::min(c + blksize + blkoffset,
 						    img.cols)));
 					fdas.at<double>(br, bc) = fda(blkwim,
-					    blkorient.at<double>(br, bc),
-					    v1sz_x, v1sz_y, this->padFlag);
-					dataVector.push_back(
+					    block.orientation, v1sz_x, v1sz_y,
+					    this->padFlag);
+					rowDataVector.push_back(
 					    fdas.at<double>(br, bc));
 				}
-				bc = bc + 1;
 			}
-			br = br + 1;
-			bc = 0;
+		});
+
+		std::vector<double> dataVector;
+		dataVector.reserve(mapRows * mapCols);
+		for (const auto &rowDataVector : rowData) {
+			dataVector.insert(dataVector.end(),
+			    rowDataVector.cbegin(), rowDataVector.cend());
 		}
 
 		const int binCount { 10 };
@@ -216,8 +201,10 @@ NFIQ2::QualityMeasures::FDA::computeFeatureData(
 		histogramBins10.push_back(FDAHISTLIMITS[6]);
 		histogramBins10.push_back(FDAHISTLIMITS[7]);
 		histogramBins10.push_back(FDAHISTLIMITS[8]);
-		addHistogramFeatures(featureDataList, NFIQ2FDAPrefix,
-		    histogramBins10, dataVector, binCount);
+		addHistogramFeatures(featureDataList,
+		    NativeQualityMeasureIndex::FrequencyDomainAnalysis::
+			Histogram::Bin0,
+		    NFIQ2FDAPrefix, histogramBins10, dataVector, binCount);
 
 		this->setSpeed(timer.stop());
 	} catch (const cv::Exception &e) {
@@ -280,68 +267,63 @@ fda(const cv::Mat &block, const double orientation, const int v1sz_x,
 		};
 	}
 
-	// rotate image to get the ridges horizontal using nearest-neighbor
-	// interpolation
-	cv::Mat blockRotated;
-	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation + (M_PI / 2),
-	    padFlag, blockRotated);
-
 	//% set x and y
 	int xoff = v1sz_x / 2;
 	int yoff = v1sz_y / 2;
 
-	// extract slanted block by cropping the rotated image: To ensure that
-	// rotated image does not contain any invalid regions.
+	// rotate image to get the ridges horizontal using nearest-neighbor
+	// interpolation, and extract slanted block by cropping the rotated
+	// image: To ensure that rotated image does not contain any invalid
+	// regions. Only the cropped block is computed.
 	//     Matlab:  blockCropped =
 	//     blockRotated(cBlock-(xoff-1):cBlock+xoff,cBlock-(yoff-1):cBlock+yoff);
 	//     % v2
 	// Note: Matlab uses matrix indices starting at 1, OpenCV starts at
 	// 0. Also, OpenCV ranges are open-ended on the upper end.
 
-	cv::Mat blockCropped = blockRotated(
-	    cv::Range((icBlock - (xoff - 1) - 1), (icBlock + xoff)),
-	    cv::Range((icBlock - (yoff - 1) - 1), (icBlock + yoff))); // v2
-
-	cv::Mat t = cv::Mat::zeros(blockCropped.rows, 1, CV_64F);
+	cv::Mat blockCropped;
+	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation + (M_PI / 2),
+	    padFlag, cv::Range((icBlock - (xoff - 1) - 1), (icBlock + xoff)),
+	    cv::Range((icBlock - (yoff - 1) - 1), (icBlock + yoff)),
+	    blockCropped); // v2
+
+	// compute dft on transposed t, zero-padded to the optimal DFT size of
+	// its length, as a complex row in stack storage rather than matrices
+	// allocated for each step. The same OpenCV functions are applied to
+	// the same values, so results are identical.
+	const int n = cv::getOptimalDFTSize(blockCropped.rows);
+	if (n > MaxRidgeSignatureSize) {
+		throw NFIQ2::Exception(
+		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
+		    "Ridge signature too large: " + std::to_string(n));
+	}
+	std::array<double, 2 * MaxRidgeSignatureSize> complexData {};
+	cv::Mat complex(1, n, CV_64FC2, complexData.data());
 	for (int r = 0; r < blockCropped.rows; r++) {
-		// get ROI for current row
-		cv::Mat roi = cv::Mat(blockCropped,
-		    cv::Rect(0, r, blockCropped.cols,
-			1)); // x,y, width, height
-		cv::Scalar s = mean(roi);
-		t.at<double>(r, 0) = s.val[0];
-		roi.release(); // is this required or does it auto clean when
-			       // done?
+		// ridge signature: mean of each row, imaginary part 0
+		complexData[2 * r] = cv::mean(blockCropped.row(r)).val[0];
 	}
-
-	// compute dft on transposed t (so using transposed dimensions)
-	cv::Mat tmpM;
-	int m = cv::getOptimalDFTSize(t.cols); // t' rows (t cols)
-	int n = cv::getOptimalDFTSize(t.rows); // t' cols (t rows)
-	// create output
-	cv::copyMakeBorder(t.t(), tmpM, 0, m - t.cols, 0, n - t.rows,
-	    cv::BORDER_CONSTANT, cv::Scalar::all(0));
-	// copy the source, on the border adding zero values
-	cv::Mat planes[] = { tmpM, cv::Mat::zeros(tmpM.size(), CV_64F) };
-	cv::Mat complex;
-	cv::merge(planes, 2, complex);
 	cv::dft(complex, complex,
 	    cv::DFT_COMPLEX_OUTPUT | cv::DFT_ROWS); // fourier transform
 
 	// Get Amplitude (Magnitude), cutting out DC (index 0,0)
 	// dftAmp = abs(cv::dft(1, 2:end));
+	std::array<double, MaxRidgeSignatureSize> reData {}, imData {},
+	    magnitudeData {};
+	cv::Mat planes[] = { cv::Mat(1, n, CV_64F, reData.data()),
+		cv::Mat(1, n, CV_64F, imData.data()) };
 	cv::split(complex, planes);
+	cv::Mat magnitude(1, n, CV_64F, magnitudeData.data());
 	cv::magnitude(planes[0], planes[1],
-	    planes[0]); // sqrt(Re(DFT(I))^2 + Im(DFT(I))^2)
-	cv::Mat absMag = abs(planes[0]);
-	cv::Mat amp(absMag,
-	    cv::Rect(1, 0, absMag.cols - 1, 1)); // set ROI, cutting out DC
+	    magnitude); // sqrt(Re(DFT(I))^2 + Im(DFT(I))^2)
+	// magnitudes are not negative, abs() would not change them
+	const cv::Mat amp(
+	    magnitude, cv::Rect(1, 0, n - 1, 1)); // set ROI, cutting out DC
 	double mVal;
 	cv::Point mLoc;
 	cv::minMaxLoc(amp, 0, &mVal, 0, &mLoc);
-	cv::Mat ampDenom(amp,
-	    cv::Rect(0, 0, (int)floor((double)(amp.cols / 2)), 1));
-	cv::Scalar iqmDenom = sum(ampDenom);
+	const cv::Mat ampDenom(amp, cv::Rect(0, 0, amp.cols / 2, 1));
+	const cv::Scalar iqmDenom = cv::sum(ampDenom);
 	if (mLoc.x == 0 || mLoc.x + 1 >= amp.cols) {
 		// ?????? FIXME
 		return 1.0;
@@ -15,7 +15,7 @@ const char NFIQ2::Identifiers::QualityMeasures::Minutiae::
     PercentOrientationCertainty80[] { "FJFXPos_OCL_MinutiaeQuality_80" };
 
 NFIQ2::QualityMeasures::FJFXMinutiaeQuality::FJFXMinutiaeQuality(
-    const NFIQ2::FingerprintImageData &fingerprintImage,
+    const NFIQ2::FingerprintImageView &fingerprintImage,
     const std::vector<FingerJetFX::Minutia> &minutiaData)
     : minutiaData_ { minutiaData }
 {
@@ -30,18 +30,18 @@ NFIQ2::QualityMeasures::FJFXMinutiaeQuality::getMinutiaData() const
 	return (this->minutiaData_);
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	NativeQualityMeasureVector featureDataList {};
 
-	std::pair<std::string, double> fd_mu;
+	std::pair<unsigned int, double> fd_mu;
 	fd_mu = std::make_pair(
-	    Identifiers::QualityMeasures::Minutiae::PercentImageMean50, -1);
+	    NativeQualityMeasureIndex::Minutiae::PercentImageMean50, -1);
 
-	std::pair<std::string, double> fd_ocl;
-	fd_ocl = std::make_pair(Identifiers::QualityMeasures::Minutiae::
+	std::pair<unsigned int, double> fd_ocl;
+	fd_ocl = std::make_pair(NativeQualityMeasureIndex::Minutiae::
 				    PercentOrientationCertainty80,
 	    -1);
 
@@ -79,7 +79,7 @@ NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeFeatureData(
 		// return relative value in relation to minutiae count
 		fd_mu.second = (double)vecRanges.at(2) /
 		    (double)this->minutiaData_.size();
-		featureDataList[fd_mu.first] = fd_mu.second;
+		featureDataList.set(fd_mu.first, fd_mu.second);
 
 		// compute minutiae quality based on OCL feature computed at
 		// minutiae positions
@@ -112,7 +112,7 @@ NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeFeatureData(
 		// return relative value in relation to minutiae count
 		fd_ocl.second = (double)vecRangesOCL.at(4) /
 		    (double)this->minutiaData_.size();
-		featureDataList[fd_ocl.first] = fd_ocl.second;
+		featureDataList.set(fd_ocl.first, fd_ocl.second);
 
 		this->setSpeed(timer.stop());
 	} catch (const cv::Exception &e) {
@@ -149,13 +149,14 @@ NFIQ2::QualityMeasures::FJFXMinutiaeQuality::getNativeQualityMeasureIDs()
 
 std::vector<NFIQ2::QualityMeasures::FJFXMinutiaeQuality::MinutiaData>
 NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeMuMinQuality(int bs,
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
 	std::vector<MinutiaData> vecMinData;
 
 	// get matrix from fingerprint image
 	cv::Mat img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-	    CV_8UC1, (void *)fingerprintImage.data());
+	    CV_8UC1, (void *)fingerprintImage.pixels,
+	    fingerprintImage.stride);
 
 	// compute overall mean and stddev
 	cv::Scalar me;
@@ -203,13 +204,14 @@ NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeMuMinQuality(int bs,
 
 std::vector<NFIQ2::QualityMeasures::FJFXMinutiaeQuality::MinutiaData>
 NFIQ2::QualityMeasures::FJFXMinutiaeQuality::computeOCLMinQuality(int bs,
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
 	std::vector<MinutiaData> vecMinData;
 
 	// get matrix from fingerprint image
 	cv::Mat img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-	    CV_8UC1, (void *)fingerprintImage.data());
+	    CV_8UC1, (void *)fingerprintImage.pixels,
+	    fingerprintImage.stride);
 
 	// iterate through all minutiae positions and
 	// compute own minutiae quality values
@@ -0,0 +1,144 @@
+#include <quality_modules/FeatureContext.h>
+#include <quality_modules/common_functions.h>
+
+#include <cmath>
+#include <utility>
+
+/** Standard deviation threshold separating foreground from background */
+static const double RidgeSegmentThreshold { .1 };
+
+NFIQ2::QualityMeasures::FeatureContext::FeatureContext(
+    const NFIQ2::FingerprintImageView &fingerprintImage,
+    ParallelFor parallelFor)
+    : fingerprintImage_ { fingerprintImage }
+    , parallelFor_ { std::move(parallelFor) }
+{
+	const int blksize = Sizes::LocalRegionSquare;
+	const int v1sz_x = Sizes::VerticallyAlignedLocalRegionWidth;
+	const int v1sz_y = Sizes::VerticallyAlignedLocalRegionHeight;
+
+	const double blk = static_cast<double>(blksize);
+	const double sumSQ = static_cast<double>(
+	    (v1sz_x * v1sz_x) + (v1sz_y * v1sz_y));
+	const double eblksz = ceil(
+	    sqrt(sumSQ)); // block size for extraction of slanted block
+	const double diff = (eblksz - blk);
+
+	this->blockOffset_ = static_cast<int>(
+	    ceil(diff / 2)); // overlapping border
+	this->blockRows_ = static_cast<int>(
+	    (static_cast<double>(fingerprintImage.height) - diff) / blk);
+	this->blockCols_ = static_cast<int>(
+	    (static_cast<double>(fingerprintImage.width) - diff) / blk);
+}
+
+const NFIQ2::FingerprintImageView &
+NFIQ2::QualityMeasures::FeatureContext::getFingerprintImage() const
+{
+	return this->fingerprintImage_;
+}
+
+const cv::Mat &
+NFIQ2::QualityMeasures::FeatureContext::getRidgeSegmentMask() const
+{
+	std::call_once(this->ridgeSegmentMaskFlag_, [this]() {
+		const cv::Mat img(this->fingerprintImage_.height,
+		    this->fingerprintImage_.width, CV_8UC1,
+		    (void *)this->fingerprintImage_.pixels,
+		    this->fingerprintImage_.stride);
+
+		ridgesegment(img, Sizes::LocalRegionSquare,
+		    RidgeSegmentThreshold, cv::noArray(),
+		    this->ridgeSegmentMask_, cv::noArray());
+	});
+
+	return this->ridgeSegmentMask_;
+}
+
+int
+NFIQ2::QualityMeasures::FeatureContext::getBlockOffset() const
+{
+	return this->blockOffset_;
+}
+
+int
+NFIQ2::QualityMeasures::FeatureContext::getBlockRows() const
+{
+	return this->blockRows_;
+}
+
+int
+NFIQ2::QualityMeasures::FeatureContext::getBlockCols() const
+{
+	return this->blockCols_;
+}
+
+void
+NFIQ2::QualityMeasures::FeatureContext::computeBlockOrientations() const
+{
+	std::call_once(this->blockOrientationsFlag_, [this]() {
+		const cv::Mat img(this->fingerprintImage_.height,
+		    this->fingerprintImage_.width, CV_8UC1,
+		    (void *)this->fingerprintImage_.pixels,
+		    this->fingerprintImage_.stride);
+		const cv::Mat &maskim = this->getRidgeSegmentMask();
+
+		const int blksize = Sizes::LocalRegionSquare;
+		std::vector<BlockOrientation> orientations {};
+		if ((this->blockRows_ > 0) && (this->blockCols_ > 0)) {
+			orientations.resize(
+			    static_cast<size_t>(this->blockRows_) *
+			    static_cast<size_t>(this->blockCols_));
+		}
+
+		this->parallelFor(this->blockRows_, [&](int br) {
+			const int r = this->blockOffset_ + (br * blksize);
+			for (int bc = 0; bc < this->blockCols_; bc++) {
+				const int c = this->blockOffset_ +
+				    (bc * blksize);
+
+				const cv::Mat im_roi = img(cv::Range(r,
+							       r + blksize),
+				    cv::Range(c, c + blksize));
+				const cv::Mat maskB1 = maskim(cv::Range(r,
+								  r + blksize),
+				    cv::Range(c, c + blksize));
+
+				BlockOrientation &block = orientations.at(
+				    static_cast<size_t>(
+					br * this->blockCols_ + bc));
+				block.foreground = allfun(maskB1);
+				covcoef(im_roi, block.cova, block.covb,
+				    block.covc, CENTERED_DIFFERENCES);
+				block.orientation = ridgeorient(block.cova,
+				    block.covb, block.covc);
+			}
+		});
+
+		this->blockOrientations_ = std::move(orientations);
+	});
+}
+
+const NFIQ2::QualityMeasures::FeatureContext::BlockOrientation &
+NFIQ2::QualityMeasures::FeatureContext::getBlockOrientation(
+    int blockRow, int blockCol) const
+{
+	this->computeBlockOrientations();
+
+	return this->blockOrientations_.at(
+	    static_cast<size_t>(blockRow * this->blockCols_ + blockCol));
+}
+
+void
+NFIQ2::QualityMeasures::FeatureContext::parallelFor(
+    const int count, const std::function<void(int)> &task) const
+{
+	if (this->parallelFor_) {
+		this->parallelFor_(count, task);
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		task(i);
+	}
+}
@@ -20,7 +20,7 @@ const char NFIQ2::Identifiers::QualityMeasures::Minutiae::CountCOM[] {
 };
 
 NFIQ2::QualityMeasures::FingerJetFX::FingerJetFX(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
 	this->setFeatures(computeFeatureData(fingerprintImage));
 }
@@ -84,11 +84,11 @@ NFIQ2::QualityMeasures::FingerJetFX::getMinutiaData() const
 	return (this->minutiaData_);
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	NativeQualityMeasureVector featureDataList {};
 
 	/*
 	 * FingerJet FX has a minimum image size, but it doesn't mind extra
@@ -102,10 +102,17 @@ NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
 	const bool imageTooSmall { (fingerprintImage.width <
 				       fingerJetMinWidth) ||
 		(fingerprintImage.height < fingerJetMinHeight) };
-	if (imageTooSmall) {
+	/*
+	 * FingerJet FX also needs contiguous rows, so a padded view (e.g., a
+	 * crop of a larger image) is copied as well.
+	 */
+	const bool copyImage { imageTooSmall ||
+		(fingerprintImage.stride != fingerprintImage.width) };
+	if (copyImage) {
 		const cv::Mat originalImage(fingerprintImage.height,
 		    fingerprintImage.width, CV_8UC1,
-		    (uint8_t *)fingerprintImage.data());
+		    (uint8_t *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 
 		biggerImageCV = cv::Mat(std::max(fingerprintImage.height,
 					    fingerJetMinHeight),
@@ -117,13 +124,13 @@ NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
 		    fingerprintImage.width, fingerprintImage.height)));
 	}
 
-	std::pair<std::string, double> fd_min_cnt;
+	std::pair<unsigned int, double> fd_min_cnt;
 	fd_min_cnt =
-	    std::make_pair(Identifiers::QualityMeasures::Minutiae::Count, 0);
+	    std::make_pair(NativeQualityMeasureIndex::Minutiae::Count, 0);
 
-	std::pair<std::string, double> fd_min_cnt_comrect200x200;
+	std::pair<unsigned int, double> fd_min_cnt_comrect200x200;
 	fd_min_cnt_comrect200x200 =
-	    std::make_pair(Identifiers::QualityMeasures::Minutiae::CountCOM, 0);
+	    std::make_pair(NativeQualityMeasureIndex::Minutiae::CountCOM, 0);
 
 	NFIQ2::Timer timer;
 	timer.start();
@@ -144,15 +151,14 @@ NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
 		    "NULL).");
 	}
 
-	const uint8_t *imageDataPtr { imageTooSmall ? biggerImageCV.ptr() :
-						      fingerprintImage.data() };
-	const uint32_t imageWidth { imageTooSmall ? biggerImageCV.cols :
-						    fingerprintImage.width };
-	const uint32_t imageHeight { imageTooSmall ? biggerImageCV.rows :
-						     fingerprintImage.height };
-	const uint64_t imageDataSize { imageTooSmall ?
-		    imageWidth * imageHeight :
-		    fingerprintImage.size() };
+	const uint8_t *imageDataPtr { copyImage ? biggerImageCV.ptr() :
+						  fingerprintImage.pixels };
+	const uint32_t imageWidth { copyImage ? biggerImageCV.cols :
+						fingerprintImage.width };
+	const uint32_t imageHeight { copyImage ? biggerImageCV.rows :
+						 fingerprintImage.height };
+	const uint64_t imageDataSize { static_cast<uint64_t>(imageWidth) *
+		imageHeight };
 
 	// extract feature set
 	const FRFXLL_RESULT fxRes = FRFXLLCreateFeatureSetFromRaw(hCtx,
@@ -230,11 +236,11 @@ NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
 	if (minCnt == 0) {
 		// return features
 		fd_min_cnt_comrect200x200.second = 0; // no minutiae found
-		featureDataList[fd_min_cnt_comrect200x200.first] =
-		    fd_min_cnt_comrect200x200.second;
+		featureDataList.set(fd_min_cnt_comrect200x200.first,
+		    fd_min_cnt_comrect200x200.second);
 
 		fd_min_cnt.second = 0; // no minutiae found
-		featureDataList[fd_min_cnt.first] = fd_min_cnt.second;
+		featureDataList.set(fd_min_cnt.first, fd_min_cnt.second);
 
 		this->setSpeed(timer.stop());
 
@@ -270,11 +276,11 @@ NFIQ2::QualityMeasures::FingerJetFX::computeFeatureData(
 
 	// return features
 	fd_min_cnt_comrect200x200.second = noOfMinInRect200x200;
-	featureDataList[fd_min_cnt_comrect200x200.first] =
-	    fd_min_cnt_comrect200x200.second;
+	featureDataList.set(fd_min_cnt_comrect200x200.first,
+	    fd_min_cnt_comrect200x200.second);
 
 	fd_min_cnt.second = minCnt;
-	featureDataList[fd_min_cnt.first] = fd_min_cnt.second;
+	featureDataList.set(fd_min_cnt.first, fd_min_cnt.second);
 
 	this->setSpeed(timer.stop());
 
@@ -311,7 +317,7 @@ NFIQ2::QualityMeasures::FingerJetFX::createContext(FRFXLL_HANDLE_PT phContext)
 
 NFIQ2::QualityMeasures::FingerJetFX::FJFXROIResults
 NFIQ2::QualityMeasures::FingerJetFX::computeROI(int bs,
-    const NFIQ2::FingerprintImageData &fingerprintImage,
+    const NFIQ2::FingerprintImageView &fingerprintImage,
     std::vector<FingerJetFX::Object> vecRectDimensions)
 {
 	unsigned int fpHeight = fingerprintImage.height;
@@ -14,7 +14,7 @@ const char NFIQ2::Identifiers::QualityMeasures::RegionOfInterest::Mean[] {
 };
 
 NFIQ2::QualityMeasures::ImgProcROI::ImgProcROI(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
 	this->setFeatures(computeFeatureData(fingerprintImage));
 }
@@ -32,11 +32,11 @@ NFIQ2::QualityMeasures::ImgProcROI::getImgProcResults()
 	return (this->imgProcResults_);
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::ImgProcROI::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -50,7 +50,8 @@ NFIQ2::QualityMeasures::ImgProcROI::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -70,12 +71,12 @@ NFIQ2::QualityMeasures::ImgProcROI::computeFeatureData(
 		this->imgProcResults_ = computeROI(img,
 		    Sizes::LocalRegionSquare);
 
-		std::pair<std::string, double> fd_roi_pixel_area_mean;
+		std::pair<unsigned int, double> fd_roi_pixel_area_mean;
 		fd_roi_pixel_area_mean = std::make_pair(
-		    Identifiers::QualityMeasures::RegionOfInterest::Mean,
+		    NativeQualityMeasureIndex::RegionOfInterest::Mean,
 		    this->imgProcResults_.meanOfROIPixels);
-		featureDataList[fd_roi_pixel_area_mean.first] =
-		    fd_roi_pixel_area_mean.second;
+		featureDataList.set(fd_roi_pixel_area_mean.first,
+		    fd_roi_pixel_area_mean.second);
 
 		this->setSpeed(timer.stop());
 	} catch (const cv::Exception &e) {
@@ -4,6 +4,7 @@
 #include <quality_modules/LCS.h>
 #include <quality_modules/common_functions.h>
 
+#include <algorithm>
 #include <sstream>
 
 const char NFIQ2::Identifiers::QualityMeasureAlgorithms::LocalClarity[] {
@@ -61,9 +62,14 @@ double loclar(cv::Mat &block, const double orientation, const int v1sz_x,
     const int v1sz_y, const int scres, const bool padFlag);
 
 NFIQ2::QualityMeasures::LCS::LCS(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
+    : LCS(FeatureContext { fingerprintImage })
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+}
+
+NFIQ2::QualityMeasures::LCS::LCS(const FeatureContext &context)
+{
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::LCS::~LCS() = default;
@@ -91,11 +97,14 @@ NFIQ2::QualityMeasures::LCS::getNativeQualityMeasureIDs()
 		Identifiers::QualityMeasures::LocalClarity::StdDev };
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::LCS::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -109,7 +118,8 @@ NFIQ2::QualityMeasures::LCS::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -123,94 +133,56 @@ NFIQ2::QualityMeasures::LCS::computeFeatureData(
 	try {
 		timerLCS.start();
 
-		int rows = img.rows;
-		int cols = img.cols;
-
 		const int v1sz_x = blocksize;
 		const int v1sz_y = blocksize / 2;
 
-		cv::Mat maskim;
-		ridgesegment(img, blocksize, threshold, cv::noArray(), maskim,
-		    cv::noArray());
-
 		// ----------
 		// compute LCS
 		// ----------
 
-		double blk = static_cast<double>(blocksize);
-
-		double sumSQ = static_cast<double>(
-		    (v1sz_x * v1sz_x) + (v1sz_y * v1sz_y));
-		double eblksz = ceil(
-		    sqrt(sumSQ)); // block size for extraction of slanted block
-		double diff = (eblksz - blk);
-		int blkoffset = static_cast<int>(
-		    ceil(diff / 2)); // overlapping border
-
-		int mapRows = static_cast<int>(
-		    (static_cast<double>(rows) - diff) / blk);
-		int mapCols = static_cast<int>(
-		    (static_cast<double>(cols) - diff) / blk);
-
-		cv::Mat maskBseg = cv::Mat::zeros(mapRows, mapCols, CV_8UC1);
-		cv::Mat blkorient = cv::Mat::zeros(mapRows, mapCols, CV_64F);
+		const int blkoffset = context.getBlockOffset();
+		const int mapRows = context.getBlockRows();
+		const int mapCols = context.getBlockCols();
 
-		std::vector<double> dataVector;
-		dataVector.reserve(mapRows * mapCols);
-
-		cv::Mat im_roi, blkwim;
-		cv::Mat maskB1;
 		cv::Mat lcs = cv::Mat::zeros(mapRows, mapCols, CV_64F);
-		double cova, covb, covc;
 		// Image processed NOT from beg to end but with a border around
 		// - can't be vectorized:(
-		int br = 0;
-		int bc = 0;
-
-		for (int r = blkoffset; r < rows - (blocksize + blkoffset - 1);
-		     r += blocksize) {
-			for (int c = blkoffset;
-			     c < cols - (blocksize + blkoffset - 1);
-			     c += blocksize) {
-				im_roi = img(cv::Range(r,
-						 cv::min(r + blocksize,
-						     img.rows)),
-				    cv::Range(c,
-					cv::min(c + blocksize, img.cols)));
-				//      blkim = im(r:r+blksz-1, c:c+blksz-1);
-				maskB1 = maskim(cv::Range(r,
-						    cv::min(r + blocksize,
-							maskim.rows)),
-				    cv::Range(c,
-					cv::min(c + blocksize, maskim.cols)));
-				//      maskB1 = maskim(r:r+blksz-1,
-				//      c:c+blksz-1);
-				maskBseg.at<uint8_t>(br, bc) = allfun(maskB1);
-				covcoef(im_roi, cova, covb, covc,
-				    CENTERED_DIFFERENCES);
-
-				// ridge ORIENT local
-				blkorient.at<double>(br, bc) = ridgeorient(cova,
-				    covb, covc);
+		// Rows of blocks may be processed concurrently, their values
+		// are gathered in row order.
+		std::vector<std::vector<double>> rowData(
+		    static_cast<size_t>(std::max(mapRows, 0)));
+		// before the loop, so that its tasks only read orientations
+		context.computeBlockOrientations();
+		context.parallelFor(mapRows, [&](int br) {
+			const int r = blkoffset + (br * blocksize);
+			std::vector<double> &rowDataVector = rowData[br];
+			for (int bc = 0; bc < mapCols; bc++) {
+				const int c = blkoffset + (bc * blocksize);
+				const FeatureContext::BlockOrientation &block =
+				    context.getBlockOrientation(br, bc);
 				// overlapping windows (border = blkoffset)
-				blkwim = img(cv::Range(r - blkoffset,
-						 cv::min(r + blocksize +
-							 blkoffset,
-						     img.rows)),
+				cv::Mat blkwim = img(cv::Range(r - blkoffset,
+							 cv::min(r + blocksize +
+								 blkoffset,
+							     img.rows)),
 				    cv::Range(c - blkoffset,
 					cv::min(c + blocksize + blkoffset,
 					    img.cols)));
 				lcs.at<double>(br, bc) = loclar(blkwim,
-				    blkorient.at<double>(br, bc), v1sz_x,
-				    v1sz_y, scannerRes, padFlag);
-				if (maskBseg.at<uint8_t>(br, bc) == 1) {
-					dataVector.push_back(
+				    block.orientation, v1sz_x, v1sz_y,
+				    scannerRes, padFlag);
+				if (block.foreground == 1) {
+					rowDataVector.push_back(
 					    lcs.at<double>(br, bc));
 				}
-				bc = bc + 1;
 			}
-			br = br + 1;
-			bc = 0;
+		});
+
+		std::vector<double> dataVector;
+		dataVector.reserve(mapRows * mapCols);
+		for (const auto &rowDataVector : rowData) {
+			dataVector.insert(dataVector.end(),
+			    rowDataVector.cbegin(), rowDataVector.cend());
 		}
 
 		std::vector<double> histogramBins10;
@@ -223,8 +195,9 @@ NFIQ2::QualityMeasures::LCS::computeFeatureData(
 		histogramBins10.push_back(LCSHISTLIMITS[6]);
 		histogramBins10.push_back(LCSHISTLIMITS[7]);
 		histogramBins10.push_back(LCSHISTLIMITS[8]);
-		addHistogramFeatures(featureDataList, NFIQ2LCSPrefix,
-		    histogramBins10, dataVector, 10);
+		addHistogramFeatures(featureDataList,
+		    NativeQualityMeasureIndex::LocalClarity::Histogram::Bin0,
+		    NFIQ2LCSPrefix, histogramBins10, dataVector, 10);
 
 		this->setSpeed(timerLCS.stop());
 	} catch (const cv::Exception &e) {
@@ -285,16 +258,13 @@ loclar(cv::Mat &block, const double orientation, const int v1sz_x,
 		};
 	}
 
-	cv::Mat blockRotated;
-	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation, padFlag,
-	    blockRotated);
-
 	//% set x and y
 	int xoff = v1sz_x / 2;
 	int yoff = v1sz_y / 2;
 
 	// extract slanted block by cropping the rotated image: To ensure that
-	// rotated image does not contain any invalid regions.
+	// rotated image does not contain any invalid regions. Only the cropped
+	// block is rotated.
 	//     Matlab:  blockCropped =
 	//     blockRotated(cBlock-(yoff-1):cBlock+yoff,cBlock-(xoff-1):cBlock+xoff);
 	//     % v2
@@ -305,8 +275,9 @@ loclar(cv::Mat &block, const double orientation, const int v1sz_x,
 	int rowend = icBlock + yoff;
 	int colstart = icBlock - (xoff - 1) - 1;
 	int colend = icBlock + xoff;
-	cv::Mat v2 = blockRotated(cv::Range(rowstart, rowend),
-	    cv::Range(colstart, colend));
+	cv::Mat v2;
+	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation, padFlag,
+	    cv::Range(rowstart, rowend), cv::Range(colstart, colend), v2);
 
 	std::vector<uint8_t> ridval;
 	std::vector<double> dt;
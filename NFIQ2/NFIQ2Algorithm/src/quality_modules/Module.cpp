@@ -15,6 +15,12 @@ NFIQ2::QualityMeasures::Algorithm::getSpeed() const
 
 std::unordered_map<std::string, double>
 NFIQ2::QualityMeasures::Algorithm::getFeatures() const
+{
+	return this->features.toMap();
+}
+
+const NFIQ2::QualityMeasures::NativeQualityMeasureVector &
+NFIQ2::QualityMeasures::Algorithm::getFeatureVector() const
 {
 	return this->features;
 }
@@ -27,7 +33,7 @@ NFIQ2::QualityMeasures::Algorithm::setSpeed(const double featureSpeed)
 
 void
 NFIQ2::QualityMeasures::Algorithm::setFeatures(
-    const std::unordered_map<std::string, double> &featureResult)
+    const NativeQualityMeasureVector &featureResult)
 {
 	this->features = featureResult;
 }
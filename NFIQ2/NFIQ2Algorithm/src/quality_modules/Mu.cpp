@@ -14,18 +14,18 @@ const char NFIQ2::Identifiers::QualityMeasures::Contrast::MeanOfBlockMeans[] {
 };
 
 NFIQ2::QualityMeasures::Mu::Mu(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
 	this->setFeatures(computeFeatureData(fingerprintImage));
 }
 
 NFIQ2::QualityMeasures::Mu::~Mu() = default;
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::Mu::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -39,7 +39,8 @@ NFIQ2::QualityMeasures::Mu::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -91,12 +92,12 @@ NFIQ2::QualityMeasures::Mu::computeFeatureData(
 		}
 
 		// return MMB value
-		std::pair<std::string, double> fd_mmb;
+		std::pair<unsigned int, double> fd_mmb;
 		fd_mmb = std::make_pair(
-		    Identifiers::QualityMeasures::Contrast::MeanOfBlockMeans,
+		    NativeQualityMeasureIndex::Contrast::MeanOfBlockMeans,
 		    avg);
 
-		featureDataList[fd_mmb.first] = fd_mmb.second;
+		featureDataList.set(fd_mmb.first, fd_mmb.second);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot compute feature Mu Mu Block (MMB): "
@@ -126,12 +127,12 @@ NFIQ2::QualityMeasures::Mu::computeFeatureData(
 		this->sigmaComputed = true;
 
 		// return mu value
-		std::pair<std::string, double> fd_mu;
+		std::pair<unsigned int, double> fd_mu;
 		fd_mu = std::make_pair(
-		    Identifiers::QualityMeasures::Contrast::ImageMean,
+		    NativeQualityMeasureIndex::Contrast::ImageMean,
 		    mu.val[0]);
 
-		featureDataList[fd_mu.first] = fd_mu.second;
+		featureDataList.set(fd_mu.first, fd_mu.second);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot compute feature Sigma (stddev) and Mu (mean): "
@@ -0,0 +1,173 @@
+#include <quality_modules/NativeQualityMeasures.h>
+
+#include <nfiq2_constants.hpp>
+
+namespace {
+namespace Measures = NFIQ2::Identifiers::QualityMeasures;
+
+/**
+ * Identifiers of native quality measures, by index.
+ *
+ * This is the order of features of the random forest. Any modification to
+ * this ordering will result in incorrectly generated NFIQ 2 scores.
+ */
+const char *const NativeQualityMeasureIdentifiers[] {
+	Measures::FrequencyDomainAnalysis::Histogram::Bin0,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin1,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin2,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin3,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin4,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin5,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin6,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin7,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin8,
+	Measures::FrequencyDomainAnalysis::Histogram::Bin9,
+	Measures::FrequencyDomainAnalysis::Mean,
+	Measures::FrequencyDomainAnalysis::StdDev,
+	Measures::Minutiae::CountCOM,
+	Measures::Minutiae::Count,
+	Measures::Minutiae::PercentImageMean50,
+	Measures::Minutiae::PercentOrientationCertainty80,
+	Measures::RegionOfInterest::Mean,
+	Measures::LocalClarity::Histogram::Bin0,
+	Measures::LocalClarity::Histogram::Bin1,
+	Measures::LocalClarity::Histogram::Bin2,
+	Measures::LocalClarity::Histogram::Bin3,
+	Measures::LocalClarity::Histogram::Bin4,
+	Measures::LocalClarity::Histogram::Bin5,
+	Measures::LocalClarity::Histogram::Bin6,
+	Measures::LocalClarity::Histogram::Bin7,
+	Measures::LocalClarity::Histogram::Bin8,
+	Measures::LocalClarity::Histogram::Bin9,
+	Measures::LocalClarity::Mean,
+	Measures::LocalClarity::StdDev,
+	Measures::Contrast::MeanOfBlockMeans,
+	Measures::Contrast::ImageMean,
+	Measures::OrientationCertainty::Histogram::Bin0,
+	Measures::OrientationCertainty::Histogram::Bin1,
+	Measures::OrientationCertainty::Histogram::Bin2,
+	Measures::OrientationCertainty::Histogram::Bin3,
+	Measures::OrientationCertainty::Histogram::Bin4,
+	Measures::OrientationCertainty::Histogram::Bin5,
+	Measures::OrientationCertainty::Histogram::Bin6,
+	Measures::OrientationCertainty::Histogram::Bin7,
+	Measures::OrientationCertainty::Histogram::Bin8,
+	Measures::OrientationCertainty::Histogram::Bin9,
+	Measures::OrientationCertainty::Mean,
+	Measures::OrientationCertainty::StdDev,
+	Measures::OrientationFlow::Histogram::Bin0,
+	Measures::OrientationFlow::Histogram::Bin1,
+	Measures::OrientationFlow::Histogram::Bin2,
+	Measures::OrientationFlow::Histogram::Bin3,
+	Measures::OrientationFlow::Histogram::Bin4,
+	Measures::OrientationFlow::Histogram::Bin5,
+	Measures::OrientationFlow::Histogram::Bin6,
+	Measures::OrientationFlow::Histogram::Bin7,
+	Measures::OrientationFlow::Histogram::Bin8,
+	Measures::OrientationFlow::Histogram::Bin9,
+	Measures::OrientationFlow::Mean,
+	Measures::OrientationFlow::StdDev,
+	Measures::RegionOfInterest::CoherenceMean,
+	Measures::RegionOfInterest::CoherenceSum,
+	Measures::RidgeValleyUniformity::Histogram::Bin0,
+	Measures::RidgeValleyUniformity::Histogram::Bin1,
+	Measures::RidgeValleyUniformity::Histogram::Bin2,
+	Measures::RidgeValleyUniformity::Histogram::Bin3,
+	Measures::RidgeValleyUniformity::Histogram::Bin4,
+	Measures::RidgeValleyUniformity::Histogram::Bin5,
+	Measures::RidgeValleyUniformity::Histogram::Bin6,
+	Measures::RidgeValleyUniformity::Histogram::Bin7,
+	Measures::RidgeValleyUniformity::Histogram::Bin8,
+	Measures::RidgeValleyUniformity::Histogram::Bin9,
+	Measures::RidgeValleyUniformity::Mean,
+	Measures::RidgeValleyUniformity::StdDev,
+};
+
+static_assert(sizeof(NativeQualityMeasureIdentifiers) /
+	    sizeof(NativeQualityMeasureIdentifiers[0]) ==
+	NFIQ2::QualityMeasures::NativeQualityMeasureIndex::Count,
+    "Each native quality measure needs an identifier");
+}
+
+void
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::set(
+    const unsigned int index, const double value)
+{
+	this->values[index] = value;
+	this->present.set(index);
+}
+
+bool
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::has(
+    const unsigned int index) const
+{
+	return this->present.test(index);
+}
+
+bool
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::empty() const
+{
+	return this->present.none();
+}
+
+unsigned int
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::firstMissing() const
+{
+	unsigned int index {};
+	while ((index < NativeQualityMeasureIndex::Count) &&
+	    this->present.test(index)) {
+		++index;
+	}
+	return index;
+}
+
+void
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::merge(
+    const NativeQualityMeasureVector &other)
+{
+	for (unsigned int i {}; i < NativeQualityMeasureIndex::Count; ++i) {
+		if (other.present.test(i) && !this->present.test(i)) {
+			this->set(i, other.values[i]);
+		}
+	}
+}
+
+const double *
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::data() const
+{
+	return this->values.data();
+}
+
+std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::toMap() const
+{
+	std::unordered_map<std::string, double> map {};
+	for (unsigned int i {}; i < NativeQualityMeasureIndex::Count; ++i) {
+		if (this->present.test(i)) {
+			map[NativeQualityMeasureIdentifiers[i]] =
+			    this->values[i];
+		}
+	}
+	return map;
+}
+
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::fromMap(
+    const std::unordered_map<std::string, double> &map)
+{
+	NativeQualityMeasureVector vector {};
+	for (unsigned int i {}; i < NativeQualityMeasureIndex::Count; ++i) {
+		const auto it = map.find(NativeQualityMeasureIdentifiers[i]);
+		if (it != map.cend()) {
+			vector.set(i, it->second);
+		}
+	}
+	return vector;
+}
+
+const char *
+NFIQ2::QualityMeasures::NativeQualityMeasureVector::getIdentifier(
+    const unsigned int index)
+{
+	return NativeQualityMeasureIdentifiers[index];
+}
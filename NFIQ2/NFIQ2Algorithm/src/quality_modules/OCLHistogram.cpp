@@ -3,6 +3,7 @@
 #include <quality_modules/OCLHistogram.h>
 #include <quality_modules/common_functions.h>
 
+#include <algorithm>
 #include <sstream>
 
 const char
@@ -38,18 +39,27 @@ const char NFIQ2::Identifiers::QualityMeasures::OrientationCertainty::StdDev[] {
 };
 
 NFIQ2::QualityMeasures::OCLHistogram::OCLHistogram(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
+    : OCLHistogram(FeatureContext { fingerprintImage })
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+}
+
+NFIQ2::QualityMeasures::OCLHistogram::OCLHistogram(
+    const FeatureContext &context)
+{
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::OCLHistogram::~OCLHistogram() = default;
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::OCLHistogram::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	cv::Mat img;
 
@@ -64,7 +74,8 @@ NFIQ2::QualityMeasures::OCLHistogram::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -81,7 +92,13 @@ NFIQ2::QualityMeasures::OCLHistogram::computeFeatureData(
 		timerOCL.start();
 
 		// divide into blocks
-		for (int i = 0; i < img.rows; i += BS_OCL) {
+		// Rows of blocks may be processed concurrently, their values
+		// are gathered in row order.
+		const int blockRows = (img.rows + BS_OCL - 1) / BS_OCL;
+		std::vector<std::vector<double>> rowOclres(
+		    static_cast<size_t>(std::max(blockRows, 0)));
+		context.parallelFor(blockRows, [&](int blockRow) {
+			const int i = blockRow * BS_OCL;
 			for (int j = 0; j < img.cols; j += BS_OCL) {
 				unsigned int actualBS_X = ((img.cols - j) <
 							      BS_OCL) ?
@@ -108,9 +125,14 @@ NFIQ2::QualityMeasures::OCLHistogram::computeFeatureData(
 						continue; // block is not used
 					}
 
-					oclres.push_back(bl_ocl);
+					rowOclres[blockRow].push_back(bl_ocl);
 				}
 			}
+		});
+
+		for (const auto &rowOcl : rowOclres) {
+			oclres.insert(
+			    oclres.end(), rowOcl.cbegin(), rowOcl.cend());
 		}
 
 		std::vector<double> histogramBins10;
@@ -123,8 +145,10 @@ NFIQ2::QualityMeasures::OCLHistogram::computeFeatureData(
 		histogramBins10.push_back(OCLPHISTLIMITS[6]);
 		histogramBins10.push_back(OCLPHISTLIMITS[7]);
 		histogramBins10.push_back(OCLPHISTLIMITS[8]);
-		addHistogramFeatures(featureDataList, NFIQ2OCLFeaturePrefix,
-		    histogramBins10, oclres, 10);
+		addHistogramFeatures(featureDataList,
+		    NativeQualityMeasureIndex::OrientationCertainty::
+			Histogram::Bin0,
+		    NFIQ2OCLFeaturePrefix, histogramBins10, oclres, 10);
 
 		this->setSpeed(timerOCL.stop());
 	} catch (const cv::Exception &e) {
@@ -60,9 +60,14 @@ const char NFIQ2::Identifiers::QualityMeasures::OrientationFlow::StdDev[] {
 };
 
 NFIQ2::QualityMeasures::OF::OF(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
+    : OF(FeatureContext { fingerprintImage })
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+}
+
+NFIQ2::QualityMeasures::OF::OF(const FeatureContext &context)
+{
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::OF::~OF() = default;
@@ -90,11 +95,14 @@ NFIQ2::QualityMeasures::OF::getNativeQualityMeasureIDs()
 		Identifiers::QualityMeasures::OrientationFlow::StdDev };
 }
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::OF::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -104,90 +112,29 @@ NFIQ2::QualityMeasures::OF::computeFeatureData(
 		    "Only 500 dpi fingerprint images are supported!");
 	}
 
-	cv::Mat img;
-	try {
-		// get matrix from fingerprint image
-		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
-	} catch (const cv::Exception &e) {
-		std::stringstream ssErr;
-		ssErr << "Cannot get matrix from fingerprint image: "
-		      << e.what();
-		throw NFIQ2::Exception(
-		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
-		    ssErr.str());
-	}
-
 	NFIQ2::Timer timerOF;
 	try {
 		timerOF.start();
 
-		int rows = img.rows;
-		int cols = img.cols;
-
-		const int v1sz_x = slantedBlockSizeX;
-		const int v1sz_y = slantedBlockSizeY;
-
-		cv::Mat maskim;
-		ridgesegment(img, blocksize, threshold, cv::noArray(), maskim,
-		    cv::noArray());
-
 		// ----------
 		// compute Of
 		// ----------
 
-		double blk = static_cast<double>(blocksize);
-
-		double sumSQ = static_cast<double>(
-		    (v1sz_x * v1sz_x) + (v1sz_y * v1sz_y));
-		double eblksz = ceil(
-		    sqrt(sumSQ)); // block size for extraction of slanted block
-		double diff = (eblksz - blk);
-		int blkoffset = static_cast<int>(
-		    ceil(diff / 2)); // overlapping border
-
-		int mapRows = static_cast<int>(
-		    (static_cast<double>(rows) - diff) / blk);
-		int mapCols = static_cast<int>(
-		    (static_cast<double>(cols) - diff) / blk);
+		const int mapRows = context.getBlockRows();
+		const int mapCols = context.getBlockCols();
 
 		cv::Mat maskBseg = cv::Mat::zeros(mapRows, mapCols, CV_8UC1);
 		cv::Mat blkorient = cv::Mat::zeros(mapRows, mapCols, CV_64F);
 
-		cv::Mat im_roi, blkwim;
-		cv::Mat maskB1;
-		double cova, covb, covc;
-		// Image processed NOT from beg to end but with a border around
-		// - can't be vectorized:(
-		int br = 0;
-		int bc = 0;
-
-		for (int r = blkoffset; r < rows - (blocksize + blkoffset - 1);
-		     r += blocksize) {
-			for (int c = blkoffset;
-			     c < cols - (blocksize + blkoffset - 1);
-			     c += blocksize) {
-				im_roi = img(cv::Range(r,
-						 cv::min(r + blocksize,
-						     img.rows)),
-				    cv::Range(c,
-					cv::min(c + blocksize, img.cols)));
-				maskB1 = maskim(cv::Range(r,
-						    cv::min(r + blocksize,
-							maskim.rows)),
-				    cv::Range(c,
-					cv::min(c + blocksize, maskim.cols)));
-				maskBseg.at<uint8_t>(br, bc) = allfun(maskB1);
-				covcoef(im_roi, cova, covb, covc,
-				    CENTERED_DIFFERENCES);
-
+		for (int br = 0; br < mapRows; br++) {
+			for (int bc = 0; bc < mapCols; bc++) {
+				const FeatureContext::BlockOrientation &block =
+				    context.getBlockOrientation(br, bc);
+				maskBseg.at<uint8_t>(br, bc) = block.foreground;
 				// ridge ORIENT local
-				blkorient.at<double>(br, bc) = ridgeorient(cova,
-				    covb, covc);
-				bc = bc + 1;
+				blkorient.at<double>(br, bc) =
+				    block.orientation;
 			}
-			br = br + 1;
-			bc = 0;
 		}
 
 		// % get the diff of orient. angles from neighbouring blocks
@@ -209,7 +156,10 @@ NFIQ2::QualityMeasures::OF::computeFeatureData(
 
 		constexpr double Deg2Rad = M_PI / 180.0;
 		constexpr double ThreeSixtyRad = Deg2Rad * 360.0;
-		for (int i = 1; i <= blkorient.rows; i++) {
+		// Rows of blocks may be processed concurrently, each writes its
+		// own row of loqall.
+		context.parallelFor(blkorient.rows, [&](int row) {
+			const int i = row + 1;
 			for (int j = 1; j <= blkorient.cols; j++) {
 				// remember: OpenCV ranges are open-ended on the
 				// upper end
@@ -234,7 +184,7 @@ NFIQ2::QualityMeasures::OF::computeFeatureData(
 				    (bsize - 1);
 				loqall.at<double>(i - 1, j - 1) = loq.val[0];
 			}
-		}
+		});
 
 		// angdiff     = deg2rad(90-angmin);
 		// angmin      = deg2rad(angmin);
@@ -307,8 +257,9 @@ NFIQ2::QualityMeasures::OF::computeFeatureData(
 		histogramBins10.push_back(OFHISTLIMITS[6]);
 		histogramBins10.push_back(OFHISTLIMITS[7]);
 		histogramBins10.push_back(OFHISTLIMITS[8]);
-		addHistogramFeatures(featureDataList, NFIQ2OFPrefix,
-		    histogramBins10, dataVector, 10);
+		addHistogramFeatures(featureDataList,
+		    NativeQualityMeasureIndex::OrientationFlow::Histogram::Bin0,
+		    NFIQ2OFPrefix, histogramBins10, dataVector, 10);
 
 		this->setSpeed(timerOF.stop());
 	} catch (const cv::Exception &e) {
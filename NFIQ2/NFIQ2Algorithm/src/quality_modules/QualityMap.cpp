@@ -3,6 +3,7 @@
 #include <quality_modules/ImgProcROI.h>
 #include <quality_modules/QualityMap.h>
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -20,20 +21,29 @@ const char
     };
 
 NFIQ2::QualityMeasures::QualityMap::QualityMap(
-    const NFIQ2::FingerprintImageData &fingerprintImage,
+    const NFIQ2::FingerprintImageView &fingerprintImage,
+    const ImgProcROI::ImgProcROIResults &imgProcResults)
+    : QualityMap(FeatureContext { fingerprintImage }, imgProcResults)
+{
+}
+
+NFIQ2::QualityMeasures::QualityMap::QualityMap(const FeatureContext &context,
     const ImgProcROI::ImgProcROIResults &imgProcResults)
     : imgProcResults_ { imgProcResults }
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::QualityMap::~QualityMap() = default;
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::QualityMap::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -50,7 +60,8 @@ NFIQ2::QualityMeasures::QualityMap::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -68,24 +79,24 @@ NFIQ2::QualityMeasures::QualityMap::computeFeatureData(
 		// get orientation map with ROI filter
 		double coherenceSumFilter = 0.0;
 		double coherenceRelFilter = 0.0;
-		cv::Mat orientationMapImgFilter = computeOrientationMap(img,
-		    true, coherenceSumFilter, coherenceRelFilter,
+		cv::Mat orientationMapImgFilter = computeOrientationMap(context,
+		    img, true, coherenceSumFilter, coherenceRelFilter,
 		    Sizes::LocalRegionSquare, this->imgProcResults_);
 
 		// return features based on coherence values of orientation map
-		std::pair<std::string, double> fd_om_2;
-		fd_om_2 = std::make_pair(Identifiers::QualityMeasures::
-					     RegionOfInterest::CoherenceMean,
+		std::pair<unsigned int, double> fd_om_2;
+		fd_om_2 = std::make_pair(
+		    NativeQualityMeasureIndex::RegionOfInterest::CoherenceMean,
 		    coherenceRelFilter);
 
-		featureDataList[fd_om_2.first] = fd_om_2.second;
+		featureDataList.set(fd_om_2.first, fd_om_2.second);
 
-		std::pair<std::string, double> fd_om_1;
-		fd_om_1 = std::make_pair(Identifiers::QualityMeasures::
-					     RegionOfInterest::CoherenceSum,
+		std::pair<unsigned int, double> fd_om_1;
+		fd_om_1 = std::make_pair(
+		    NativeQualityMeasureIndex::RegionOfInterest::CoherenceSum,
 		    coherenceSumFilter);
 
-		featureDataList[fd_om_1.first] = fd_om_1.second;
+		featureDataList.set(fd_om_1.first, fd_om_1.second);
 
 		this->setSpeed(timer.stop());
 	} catch (const cv::Exception &e) {
@@ -102,9 +113,10 @@ NFIQ2::QualityMeasures::QualityMap::computeFeatureData(
 }
 
 cv::Mat
-NFIQ2::QualityMeasures::QualityMap::computeOrientationMap(cv::Mat &img,
-    bool bFilterByROI, double &coherenceSum, double &coherenceRel,
-    unsigned int bs, ImgProcROI::ImgProcROIResults roiResults)
+NFIQ2::QualityMeasures::QualityMap::computeOrientationMap(
+    const FeatureContext &context, cv::Mat &img, bool bFilterByROI,
+    double &coherenceSum, double &coherenceRel, unsigned int bs,
+    ImgProcROI::ImgProcROIResults roiResults)
 {
 	coherenceSum = 0.0;
 	coherenceRel = 0.0;
@@ -116,7 +128,13 @@ NFIQ2::QualityMeasures::QualityMap::computeOrientationMap(cv::Mat &img,
 	    cv::Scalar(0, 0, 0, 0)); // empty black image
 
 	// divide into blocks
-	for (int i = 0; i < img.rows; i += bs) {
+	// Rows of blocks may be processed concurrently. Each writes its own
+	// pixels of omImg, coherence values are summed up in row order.
+	const int blockRows = (img.rows + (int)bs - 1) / (int)bs;
+	std::vector<std::vector<double>> rowCoherences(
+	    static_cast<size_t>(std::max(blockRows, 0)));
+	context.parallelFor(blockRows, [&](int blockRow) {
+		const int i = blockRow * (int)bs;
 		for (int j = 0; j < img.cols; j += bs) {
 			int actualBS_X = ((img.cols - j) < (int)bs) ?
 			    (img.cols - j) :
@@ -180,7 +198,7 @@ NFIQ2::QualityMeasures::QualityMap::computeOrientationMap(cv::Mat &img,
 			if (std::isnan(coherence)) {
 				coherence = 0.0;
 			}
-			coherenceSum += coherence;
+			rowCoherences[blockRow].push_back(coherence);
 
 			// draw angle to final orientation map
 			// angle in degrees = greyvalue of block
@@ -194,6 +212,12 @@ NFIQ2::QualityMeasures::QualityMap::computeOrientationMap(cv::Mat &img,
 				}
 			}
 		}
+	});
+
+	for (const auto &coherences : rowCoherences) {
+		for (const double coherence : coherences) {
+			coherenceSum += coherence;
+		}
 	}
 
 	if (bFilterByROI) {
@@ -4,6 +4,7 @@
 #include <quality_modules/RVUPHistogram.h>
 #include <quality_modules/common_functions.h>
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -45,18 +46,26 @@ void rvuhist(cv::Mat block, const double orientation, const int v1sz_x,
     std::vector<uint8_t> &Nans);
 
 NFIQ2::QualityMeasures::RVUPHistogram::RVUPHistogram(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const NFIQ2::FingerprintImageView &fingerprintImage)
+    : RVUPHistogram(FeatureContext { fingerprintImage })
 {
-	this->setFeatures(computeFeatureData(fingerprintImage));
+}
+
+NFIQ2::QualityMeasures::RVUPHistogram::RVUPHistogram(const FeatureContext &context)
+{
+	this->setFeatures(computeFeatureData(context));
 }
 
 NFIQ2::QualityMeasures::RVUPHistogram::~RVUPHistogram() = default;
 
-std::unordered_map<std::string, double>
+NFIQ2::QualityMeasures::NativeQualityMeasureVector
 NFIQ2::QualityMeasures::RVUPHistogram::computeFeatureData(
-    const NFIQ2::FingerprintImageData &fingerprintImage)
+    const FeatureContext &context)
 {
-	std::unordered_map<std::string, double> featureDataList;
+	const NFIQ2::FingerprintImageView &fingerprintImage =
+	    context.getFingerprintImage();
+
+	NativeQualityMeasureVector featureDataList {};
 
 	// check if input image has 500 dpi
 	if (fingerprintImage.ppi !=
@@ -70,7 +79,8 @@ NFIQ2::QualityMeasures::RVUPHistogram::computeFeatureData(
 	try {
 		// get matrix from fingerprint image
 		img = cv::Mat(fingerprintImage.height, fingerprintImage.width,
-		    CV_8UC1, (void *)fingerprintImage.data());
+		    CV_8UC1, (void *)fingerprintImage.pixels,
+		    fingerprintImage.stride);
 	} catch (const cv::Exception &e) {
 		std::stringstream ssErr;
 		ssErr << "Cannot get matrix from fingerprint image: "
@@ -88,86 +98,52 @@ NFIQ2::QualityMeasures::RVUPHistogram::computeFeatureData(
 	try {
 		timerRVU.start();
 
-		cv::Mat maskim;
 		const int blksize = this->blocksize;
 		const int v1sz_x = this->slantedBlockSizeX;
 		const int v1sz_y = this->slantedBlockSizeY;
 
-		assert((blksize > 0) && (this->threshold > 0));
-
-		ridgesegment(img, blksize, this->threshold, cv::noArray(),
-		    maskim, cv::noArray());
-
-		int rows = img.rows;
-		int cols = img.cols;
-		double blk = static_cast<double>(blksize);
-
-		double sumSQ = static_cast<double>(
-		    (v1sz_x * v1sz_x) + (v1sz_y * v1sz_y));
-		double eblksz = ceil(
-		    sqrt(sumSQ)); // block size for extraction of slanted block
-		double diff = (eblksz - blk);
-		int blkoffset = static_cast<int>(
-		    ceil(diff / 2)); // overlapping border
-
-		int mapRows = static_cast<int>(
-		    (static_cast<double>(rows) - diff) / blk);
-		int mapCols = static_cast<int>(
-		    (static_cast<double>(cols) - diff) / blk);
+		assert(blksize > 0);
 
-		cv::Mat maskBseg = cv::Mat::zeros(mapRows, mapCols, CV_8UC1);
-		cv::Mat blkorient = cv::Mat::zeros(mapRows, mapCols, CV_64F);
+		const int blkoffset = context.getBlockOffset();
+		const int mapRows = context.getBlockRows();
+		const int mapCols = context.getBlockCols();
 
-		cv::Mat im_roi, blkwim;
-		cv::Mat maskB1;
-		double cova, covb, covc;
 		// Image processed NOT from beg to end but with a border around
 		// - can't be vectorized:(
-		int br = 0;
-		int bc = 0;
-
-		std::vector<double> rvures;
-		std::vector<uint8_t> NanVec;
-		for (int r = blkoffset; r < rows - (blksize + blkoffset - 1);
-		     r += blksize) {
-			for (int c = blkoffset;
-			     c < cols - (blksize + blkoffset - 1);
-			     c += blksize) {
-				im_roi = img(cv::Range(r,
-						 cv::min(r + blksize,
-						     img.rows)),
-				    cv::Range(c,
-					cv::min(c + blksize, img.cols)));
-				maskB1 = maskim(cv::Range(r,
-						    cv::min(r + blksize,
-							maskim.rows)),
-				    cv::Range(c,
-					cv::min(c + blksize, maskim.cols)));
-				maskBseg.at<uint8_t>(br, bc) = allfun(maskB1);
-				covcoef(im_roi, cova, covb, covc,
-				    CENTERED_DIFFERENCES);
-
-				// ridge ORIENT local
-				blkorient.at<double>(br, bc) = ridgeorient(cova,
-				    covb, covc);
-				// overlapping windows (border = blkoffset)
-				blkwim = img(cv::Range(r - blkoffset,
-						 cv::min(r + blksize +
-							 blkoffset,
-						     img.rows)),
-				    cv::Range(c - blkoffset,
-					cv::min(c + blksize + blkoffset,
-					    img.cols)));
-				if (maskBseg.at<uint8_t>(br, bc) == 1) {
-					rvuhist(blkwim,
-					    blkorient.at<double>(br, bc),
+		// Rows of blocks may be processed concurrently, their values
+		// are gathered in row order.
+		std::vector<std::vector<double>> rowRvures(
+		    static_cast<size_t>(std::max(mapRows, 0)));
+		// before the loop, so that its tasks only read orientations
+		context.computeBlockOrientations();
+		context.parallelFor(mapRows, [&](int br) {
+			const int r = blkoffset + (br * blksize);
+			std::vector<uint8_t> NanVec;
+			for (int bc = 0; bc < mapCols; bc++) {
+				const int c = blkoffset + (bc * blksize);
+				const FeatureContext::BlockOrientation &block =
+				    context.getBlockOrientation(br, bc);
+				if (block.foreground == 1) {
+					// overlapping windows (border =
+					// blkoffset)
+					const cv::Mat blkwim = img(
+					    cv::Range(r - blkoffset,
+						cv::min(r + blksize + blkoffset,
+						    img.rows)),
+					    cv::Range(c - blkoffset,
+						cv::min(c + blksize + blkoffset,
+						    img.cols)));
+					rvuhist(blkwim, block.orientation,
 					    v1sz_x, v1sz_y, this->padFlag,
-					    rvures, NanVec);
+					    rowRvures[br], NanVec);
 				}
-				bc = bc + 1;
 			}
-			br = br + 1;
-			bc = 0;
+		});
+
+		std::vector<double> rvures;
+		for (const auto &rowRvu : rowRvures) {
+			rvures.insert(
+			    rvures.end(), rowRvu.cbegin(), rowRvu.cend());
 		}
 
 		// RIDGE-VALLEY UNIFORMITY
@@ -181,8 +157,10 @@ NFIQ2::QualityMeasures::RVUPHistogram::computeFeatureData(
 		histogramBins10.push_back(RVUPHISTLIMITS[6]);
 		histogramBins10.push_back(RVUPHISTLIMITS[7]);
 		histogramBins10.push_back(RVUPHISTLIMITS[8]);
-		addHistogramFeatures(featureDataList, NFIQ2RVUPFeaturePrefix,
-		    histogramBins10, rvures, 10);
+		addHistogramFeatures(featureDataList,
+		    NativeQualityMeasureIndex::RidgeValleyUniformity::
+			Histogram::Bin0,
+		    NFIQ2RVUPFeaturePrefix, histogramBins10, rvures, 10);
 
 		this->setSpeed(timerRVU.stop());
 	} catch (const cv::Exception &e) {
@@ -280,25 +258,24 @@ rvuhist(cv::Mat block, const double orientation, const int v1sz_x,
 		};
 	}
 
-	cv::Mat blockRotated;
-	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation, padFlag,
-	    blockRotated);
-
 	//% set x and y
 	int xoff = v1sz_x / 2;
 	int yoff = v1sz_y / 2;
 
 	// extract slanted block by cropping the rotated image: To ensure that
-	// rotated image does not contain any invalid regions.
+	// rotated image does not contain any invalid regions. Only the cropped
+	// block is rotated.
 	//     Matlab:  blockCropped =
 	//     blockRotated(cBlock-(yoff-1):cBlock+yoff,cBlock-(xoff-1):cBlock+xoff);
 	//     % v2
 	// Note: Matlab uses matrix indices starting at 1, OpenCV starts at 0.
 	// Also, OpenCV ranges are open-ended on the upper end.
 
-	cv::Mat blockCropped = blockRotated(
+	cv::Mat blockCropped;
+	NFIQ2::QualityMeasures::getRotatedBlock(block, orientation, padFlag,
 	    cv::Range((icBlock - (yoff - 1) - 1), (icBlock + yoff)),
-	    cv::Range((icBlock - (xoff - 1) - 1), (icBlock + xoff))); // v2
+	    cv::Range((icBlock - (xoff - 1) - 1), (icBlock + xoff)),
+	    blockCropped); // v2
 
 	std::vector<uint8_t> ridval;
 	std::vector<double> dt;
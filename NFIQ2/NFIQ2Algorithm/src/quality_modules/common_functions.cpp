@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 
@@ -54,44 +55,184 @@ NFIQ2::QualityMeasures::ridgesegment(const cv::Mat &img, int blksze,
     cv::OutputArray _maskIndex)
 
 {
-	/***Convert the input image to double.
+	/***Convert the input image to double and normalize it to have zero
+	mean, unit standard deviation. Only computed if the normalized image is
+	requested or a block is too close to the threshold to be decided from
+	integer sums below.
 	Matlab: im = double(im);
-	***/
-	cv::Mat double_im;
-	img.convertTo(double_im, CV_64F);
-
-	/***Normalize the image to have zero mean, unit standard deviation
 	Matlab: im = (im-mean(im(:))) ./ std(im(:));
 	***/
+	cv::Mat double_im;
 	cv::Scalar imMean = 0, imStd = 0;
-	cv::meanStdDev(double_im, imMean, imStd, cv::noArray());
-	double_im = (double_im - imMean.val[0]) / imStd.val[0];
-	/***For each block in the image, compute the standard deviation. Replace
-	each element of the block with its standard deviation value. Matlab: fun
-	= inline('std(x(:))*ones(size(x))'); stddevim = blkproc(im, [blksze
-	blksze], fun);
+	const auto normalized = [&]() -> const cv::Mat & {
+		if (double_im.empty()) {
+			img.convertTo(double_im, CV_64F);
+			cv::meanStdDev(
+			    double_im, imMean, imStd, cv::noArray());
+			double_im = (double_im - imMean.val[0]) /
+			    imStd.val[0];
+		}
+		return double_im;
+	};
+
+	/***For each block in the image, compute the standard deviation of the
+	normalized image and compare it to the threshold. Matlab: fun =
+	inline('std(x(:))*ones(size(x))'); stddevim = blkproc(im, [blksze
+	blksze], fun); mask = stddevim > thresh;
+
+	The standard deviation of a normalized block is that of the block
+	divided by the standard deviation of the image. Both are derived from
+	exact integer sums of 8-bit pixels, one pass over the image, without
+	cancellation. Blocks too close to the threshold for rounding errors of
+	either computation to be ruled out are evaluated on the normalized image
+	instead, so that the mask is the one MATLAB-derived code computed.
 	***/
+	const int blockRows = (img.rows + blksze - 1) / blksze;
+	const int blockCols = (img.cols + blksze - 1) / blksze;
+	const auto blockPixels = [&](const int br, const int bc) {
+		return static_cast<int64_t>(
+			   cv::min(blksze, img.rows - (br * blksze))) *
+		    cv::min(blksze, img.cols - (bc * blksze));
+	};
+
+	/* Sum of pixels and pixels^2 * count - sum^2 of each block */
+	std::vector<int64_t> blockSums(blockRows * blockCols);
+	std::vector<int64_t> blockDeviations(blockRows * blockCols);
+	bool fromSums = (img.type() == CV_8UC1) && (thresh > 0) &&
+	    !img.empty();
+	if (fromSums) {
+		std::vector<int64_t> blockSquares(blockCols);
+		for (int br = 0; br < blockRows; br++) {
+			int64_t *sums = blockSums.data() + (br * blockCols);
+			std::fill(blockSquares.begin(), blockSquares.end(), 0);
+
+			const int lastRow = cv::min(
+			    (br + 1) * blksze, img.rows);
+			for (int i = br * blksze; i < lastRow; i++) {
+				const uint8_t *row = img.ptr<uint8_t>(i);
+				for (int bc = 0; bc < blockCols; bc++) {
+					const int lastCol = cv::min(
+					    (bc + 1) * blksze, img.cols);
+					int64_t sum = 0, squares = 0;
+					for (int j = bc * blksze; j < lastCol;
+					     j++) {
+						sum += row[j];
+						squares += row[j] * row[j];
+					}
+					sums[bc] += sum;
+					blockSquares[bc] += squares;
+				}
+			}
 
-	cv::Mat stddevim = double_im.clone();
-	cv::Mat im_roi;
+			for (int bc = 0; bc < blockCols; bc++) {
+				blockDeviations[(br * blockCols) + bc] =
+				    (blockPixels(br, bc) * blockSquares[bc]) -
+				    (sums[bc] * sums[bc]);
+			}
+		}
+	}
 
-	for (int r = 0; r < stddevim.rows; r += blksze) {
-		for (int c = 0; c < stddevim.cols; c += blksze) {
-			// cv::Range is open-ended on the upper end: r <= i < r
-			// + blksze
-			im_roi = stddevim(
-			    cv::Range(r, cv::min(r + blksze, stddevim.rows)),
-			    cv::Range(c, cv::min(c + blksze, stddevim.cols)));
-			cv::meanStdDev(im_roi, imMean, imStd, cv::noArray());
-			im_roi = imStd.val[0];
+	/* Law of total variance, with non-negative terms */
+	const int64_t pixels = static_cast<int64_t>(img.rows) * img.cols;
+	int64_t sum = 0;
+	for (const int64_t blockSum : blockSums) {
+		sum += blockSum;
+	}
+	const auto meanOffset = [&](const int b, const int64_t n) {
+		/* (block mean - image mean) * pixels * n */
+		return static_cast<double>(
+		    (pixels * blockSums[b]) - (n * sum));
+	};
+	double variance = 0;
+	for (int br = 0; fromSums && (br < blockRows); br++) {
+		for (int bc = 0; bc < blockCols; bc++) {
+			const int b = (br * blockCols) + bc;
+			const int64_t n = blockPixels(br, bc);
+			const double offset = meanOffset(b, n);
+			variance +=
+			    (blockDeviations[b] / static_cast<double>(n)) +
+			    (offset * offset /
+				(static_cast<double>(pixels) * pixels * n));
 		}
 	}
+	variance /= static_cast<double>(pixels);
+	fromSums = fromSums && (variance > 0);
+
+	/*
+	 * Bound on the difference between blockVariance below and the
+	 * squared standard deviation OpenCV computes for the same block of
+	 * the normalized image, with u the unit roundoff, m and var the mean
+	 * and variance of the image and n the pixels of the block:
+	 *  - image standard deviation: meanStdDev() sums 8-bit pixels and
+	 *    their squares exactly, then rounds sq / N - m^2 and the
+	 *    reciprocal scale, scaling block variances by at most
+	 *    12u (1 + m^2 / var);
+	 *  - normalized pixels: apart from an offset common to all, each
+	 *    is off by at most E = 4u (255 + m) / sqrt(var), moving the
+	 *    block variance by at most 2 sqrt(blockVariance) E + E^2;
+	 *  - block meanStdDev(): sums of n terms, in any order, are off by
+	 *    at most (n + 8)u (meanSquare + blockVariance);
+	 *  - blockVariance: sums of positive terms over all blocks, off by
+	 *    at most (blocks + 16)u blockVariance;
+	 *  - square root and comparison: 4u thresh^2.
+	 * The sum is doubled to cover higher order terms. Blocks that close
+	 * to the threshold are evaluated on the normalized image.
+	 */
+	const double roundoff = std::numeric_limits<double>::epsilon() / 2;
+	const double imageMean = sum / static_cast<double>(pixels);
+	const double scaleError = roundoff *
+	    ((12 * (1 + (imageMean * imageMean / variance))) +
+		(static_cast<double>(blockRows) * blockCols) + 16);
+	const double pixelError = 4 * roundoff * (255 + imageMean) /
+	    std::sqrt(variance);
 
 	maskImage.create(img.size(), CV_8UC1);
-	// OpenCV: Result of comparison is an 8-bit single channel mask whose
-	// elements are set to 255 (if the particular element satisfies the
-	// condition) or 0. Matlab: result of comparison is 1 or 0;
-	maskImage = (stddevim > thresh);
+	const double thresh2 = thresh * thresh;
+	for (int br = 0; br < blockRows; br++) {
+		for (int bc = 0; bc < blockCols; bc++) {
+			// cv::Range is open-ended on the upper end: r <= i < r
+			// + blksze
+			const cv::Range rows(
+			    br * blksze, cv::min((br + 1) * blksze, img.rows));
+			const cv::Range cols(
+			    bc * blksze, cv::min((bc + 1) * blksze, img.cols));
+
+			bool ridge = false;
+			bool decided = false;
+			if (fromSums) {
+				const int b = (br * blockCols) + bc;
+				const int64_t count = blockPixels(br, bc);
+				const double n = static_cast<double>(count);
+				const double offset = meanOffset(b, count) /
+				    (static_cast<double>(pixels) * n);
+				const double blockVariance =
+				    blockDeviations[b] / (n * n * variance);
+				const double meanSquare = offset * offset /
+				    variance;
+				const double bound = 2 *
+				    ((scaleError * blockVariance) +
+					(2 * std::sqrt(blockVariance) *
+					    pixelError) +
+					(pixelError * pixelError) +
+					((n + 8) * roundoff *
+					    (meanSquare + blockVariance)) +
+					(4 * roundoff * thresh2));
+				decided = std::abs(blockVariance - thresh2) >
+				    bound;
+				ridge = blockVariance > thresh2;
+			}
+			if (!decided) {
+				cv::Scalar blockMean = 0, blockStd = 0;
+				cv::meanStdDev(normalized()(rows, cols),
+				    blockMean, blockStd, cv::noArray());
+				ridge = blockStd.val[0] > thresh;
+			}
+
+			// OpenCV: mask elements are set to 255 or 0.
+			// Matlab: result of comparison is 1 or 0;
+			maskImage(rows, cols).setTo(ridge ? 255 : 0);
+		}
+	}
 
 	if (_maskIndex.needed()) {
 		/***Create the mask vector indicating ridge-like regions: get
@@ -115,20 +256,68 @@ NFIQ2::QualityMeasures::ridgesegment(const cv::Mat &img, int blksze,
 	}
 
 	if (_normImage.needed()) {
-		_normImage.create(double_im.size(), double_im.type());
+		const cv::Mat &norm = normalized();
+		_normImage.create(norm.size(), norm.type());
 		cv::Mat normImage = _normImage.getMat();
 
 		/***Renormalise image so that the *ridge regions* have zero
 		mean, unit standard deviation. Matlab: im = im -
 		mean(im(maskind)); normim = im/std(im(maskind));
 		***/
-		cv::meanStdDev(double_im, imMean, imStd, maskImage);
-		normImage = (double_im - imMean.val[0]) / imStd.val[0];
+		cv::meanStdDev(norm, imMean, imStd, maskImage);
+		normImage = (norm - imMean.val[0]) / imStd.val[0];
 	}
 
 	return;
 }
 
+/**
+ * covcoef() with centered differences of an 8-bit block, in one pass.
+ *
+ * @details
+ * Twice the gradients of an 8-bit block are integers, so their squares
+ * and products are summed exactly in integers. Divided by 4, these sums
+ * are the sums of gradient squares and products as doubles, which are
+ * exact in any summation order, and are then scaled as cv::mean() does.
+ * Results are therefore bit-identical to the matrix implementation.
+ */
+static void
+centeredDifferencesCovcoef(
+    const cv::Mat &imblock, double &a, double &b, double &c)
+{
+	const int rows = imblock.rows;
+	const int cols = imblock.cols;
+
+	int64_t xx = 0, yy = 0, xy = 0;
+	for (int r = 0; r < rows; r++) {
+		/* Forward differences at the edges, not halved */
+		const bool rowEdge = (r == 0) || (r == rows - 1);
+		const uint8_t *row = imblock.ptr<uint8_t>(r);
+		const uint8_t *above = imblock.ptr<uint8_t>(cv::max(r - 1, 0));
+		const uint8_t *below = imblock.ptr<uint8_t>(
+		    cv::min(r + 1, rows - 1));
+
+		const auto accumulate = [&](const int col, const int dx) {
+			const int dy = rowEdge ? 2 * (below[col] - above[col]) :
+						 below[col] - above[col];
+			xx += dx * dx;
+			yy += dy * dy;
+			xy += dx * dy;
+		};
+
+		accumulate(0, 2 * (row[1] - row[0]));
+		for (int col = 1; col < cols - 1; col++) {
+			accumulate(col, row[col + 1] - row[col - 1]);
+		}
+		accumulate(cols - 1, 2 * (row[cols - 1] - row[cols - 2]));
+	}
+
+	const double scale = 1. / (rows * cols);
+	a = (static_cast<double>(xx) / 4) * scale;
+	b = (static_cast<double>(yy) / 4) * scale;
+	c = (static_cast<double>(xy) / 4) * scale;
+}
+
 /////////////////////////////////////////////////////////////////////////
 /***function [a b c] = covcoef(blk)
 %COVCOEF Computes covariance coefficients of grey level gradients
@@ -167,6 +356,13 @@ NFIQ2::QualityMeasures::covcoef(const cv::Mat &imblock, double &a, double &b,
 	comMethod parameter controls which gradient estimation method is used.
 	***/
 
+	if ((compMethod == CENTERED_DIFFERENCES) &&
+	    (imblock.type() == CV_8UC1) && (imblock.rows > 1) &&
+	    (imblock.cols > 1)) {
+		centeredDifferencesCovcoef(imblock, a, b, c);
+		return;
+	}
+
 	cv::Mat dfx, dfy, dfxT;
 	cv::Mat doubleIm;
 
@@ -310,10 +506,20 @@ NFIQ2::QualityMeasures::diffGrad(const cv::Mat &inBlock, cv::Mat &outBlock)
 void
 NFIQ2::QualityMeasures::getRotatedBlock(const cv::Mat &block,
     const double orientation, bool padFlag, cv::Mat &rotatedBlock)
+{
+	getRotatedBlock(block, orientation, padFlag, cv::Range(0, block.rows),
+	    cv::Range(0, block.cols), rotatedBlock);
+}
+
+void
+NFIQ2::QualityMeasures::getRotatedBlock(const cv::Mat &block,
+    const double orientation, bool padFlag, const cv::Range &rows,
+    const cv::Range &cols, cv::Mat &rotatedBlock)
 {
 	const double Rad2Deg = 180.0 / M_PI;
-	cv::Mat rot_mat(2, 3, CV_64F);
-	cv::Mat Inblock;
+	/* Fixed point precision of source coordinates in cv::warpAffine() */
+	const int ABBits = 10;
+	const int ABScale = 1 << ABBits;
 
 	// sanity check: check block size
 	float cBlock = static_cast<float>(block.rows) / 2; // square block
@@ -327,51 +533,134 @@ NFIQ2::QualityMeasures::getRotatedBlock(const cv::Mat &block,
 		};
 	}
 
-	if (padFlag) {
-		cv::copyMakeBorder(block, Inblock, 2, 2, 2, 2,
-		    cv::BORDER_CONSTANT, 0);
-	} else {
-		Inblock = block;
-	}
-	try {
-		// rotate image to get the ridges vertical
-		//   Matlab:  blockRotated = imrotate(block,
-		//   rad2deg(orientation), 'nearest', 'crop');
-		rotatedBlock.create(block.rows, block.cols, block.type());
-		double orientDegrees = orientation * Rad2Deg;
-		cv::Point2f center(((float)Inblock.cols / 2.0f),
-		    ((float)Inblock.rows / 2.0f));
-		rot_mat = getRotationMatrix2D(center, orientDegrees, 1);
-		cv::warpAffine(Inblock, rotatedBlock, rot_mat,
-		    rotatedBlock.size(), cv::INTER_NEAREST);
-	} catch (const cv::Exception &e) {
-		throw NFIQ2::Exception(
-		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
-		    "Exception during block rotation: " +
-			std::string(e.what()));
+	// rotate image to get the ridges vertical
+	//   Matlab:  blockRotated = imrotate(block,
+	//   rad2deg(orientation), 'nearest', 'crop');
+	//
+	// Pixels of the rotated block are gathered from the block as
+	// cv::warpAffine() with INTER_NEAREST and a constant border of 0 would
+	// compute them for the block, after a constant border of 2 pixels if
+	// padFlag is set: the rotation is inverted and source coordinates are
+	// rounded in fixed point the same way. Only pixels within rows and
+	// cols are computed.
+	const int pad = padFlag ? 2 : 0;
+	const cv::Point2f center(
+	    (static_cast<float>(block.cols + (2 * pad)) / 2.0f),
+	    (static_cast<float>(block.rows + (2 * pad)) / 2.0f));
+	const cv::Mat rot_mat = cv::getRotationMatrix2D(
+	    center, orientation * Rad2Deg, 1);
+	double M[6];
+	for (int i = 0; i < 6; i++) {
+		M[i] = rot_mat.at<double>(i / 3, i % 3);
+	}
+
+	/* Inverse transformation, as cv::warpAffine() computes it */
+	double D = M[0] * M[4] - M[1] * M[3];
+	D = D != 0 ? 1. / D : 0;
+	const double A11 = M[4] * D, A22 = M[0] * D;
+	M[0] = A11;
+	M[1] *= -D;
+	M[3] *= -D;
+	M[4] = A22;
+	const double b1 = -M[0] * M[2] - M[1] * M[5];
+	const double b2 = -M[3] * M[2] - M[4] * M[5];
+	M[2] = b1;
+	M[5] = b2;
+
+	/* Offsets of source coordinates for each column */
+	std::vector<int> adelta(cols.size()), bdelta(cols.size());
+	for (int x = cols.start; x < cols.end; x++) {
+		adelta[x - cols.start] = cv::saturate_cast<int>(
+		    M[0] * x * ABScale);
+		bdelta[x - cols.start] = cv::saturate_cast<int>(
+		    M[3] * x * ABScale);
+	}
+
+	rotatedBlock.create(rows.size(), cols.size(), block.type());
+	const size_t elemSize = block.elemSize();
+	for (int y = rows.start; y < rows.end; y++) {
+		const int X0 = cv::saturate_cast<int>(
+				   (M[1] * y + M[2]) * ABScale) +
+		    (ABScale / 2);
+		const int Y0 = cv::saturate_cast<int>(
+				   (M[4] * y + M[5]) * ABScale) +
+		    (ABScale / 2);
+
+		uint8_t *out = rotatedBlock.ptr<uint8_t>(y - rows.start);
+		for (int x = 0; x < cols.size(); x++, out += elemSize) {
+			const int sx = ((X0 + adelta[x]) >> ABBits) - pad;
+			const int sy = ((Y0 + bdelta[x]) >> ABBits) - pad;
+			if ((sx >= 0) && (sx < block.cols) && (sy >= 0) &&
+			    (sy < block.rows)) {
+				std::memcpy(out, block.ptr<uint8_t>(sy, sx),
+				    elemSize);
+			} else {
+				std::memset(out, 0, elemSize);
+			}
+		}
 	}
 
 	return;
 }
+
+/**
+ * @return
+ * numerator / denominator rounded to 10 decimal places, with halfway cases
+ * away from zero, as round(value * 10^10) / 10^10 rounds a double.
+ */
+static double
+roundRatio(int64_t numerator, int64_t denominator)
+{
+	const int64_t Scale = 10000000000;
+	if (denominator < 0) {
+		numerator = -numerator;
+		denominator = -denominator;
+	}
+	const int64_t magnitude = numerator < 0 ? -numerator : numerator;
+	if (magnitude > (std::numeric_limits<int64_t>::max() / 2 / Scale)) {
+		return round(static_cast<double>(numerator) / denominator *
+			   Scale) /
+		    Scale;
+	}
+
+	const int64_t scaled = ((2 * magnitude * Scale) + denominator) /
+	    (2 * denominator);
+	return static_cast<double>(numerator < 0 ? -scaled : scaled) / Scale;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void
 NFIQ2::QualityMeasures::getRidgeValleyStructure(const cv::Mat &blockCropped,
     std::vector<uint8_t> &ridval, std::vector<double> &dt)
 {
+	if ((blockCropped.type() != CV_8UC1) || (blockCropped.rows < 1) ||
+	    (blockCropped.cols < 2)) {
+		throw NFIQ2::Exception(
+		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
+		    "Ridge/valley processing needs an 8-bit block of at least "
+		    "1 row and 2 columns");
+	}
+	const int n = blockCropped.cols;
+
 	// average profile of blockCropped: Compute average of each column to
 	// get a projection of the grey values down the ridges.
 	//    Matlab:  v3 = mean(blockCropped);
 	//    Note: If A is a matrix, mean(A) treats the columns of A as
 	//    vectors, returning
 	//          a row vector of mean values.
-	cv::Mat v3 = cv::Mat::zeros(blockCropped.cols, 1, CV_64F);
-	cv::Mat blockCol;
-	cv::Scalar colMean;
-	for (int i = 0; i < blockCropped.cols; i++) {
-		// extract a column from blockCropped
-		blockCol = blockCropped.col(i);
-		colMean = cv::mean(blockCol, cv::noArray());
-		v3.at<double>(i, 0) = colMean.val[0];
+	// Columns are summed exactly in one pass over the rows, and scaled as
+	// cv::mean() scales sums.
+	std::vector<int64_t> colSums(n, 0);
+	for (int r = 0; r < blockCropped.rows; r++) {
+		const uint8_t *row = blockCropped.ptr<uint8_t>(r);
+		for (int i = 0; i < n; i++) {
+			colSums[i] += row[i];
+		}
+	}
+	std::vector<double> v3(n);
+	const double meanScale = 1. / blockCropped.rows;
+	for (int i = 0; i < n; i++) {
+		v3[i] = static_cast<double>(colSums[i]) * meanScale;
 	}
 
 	// %% Linear regression using least square
@@ -382,42 +671,39 @@ NFIQ2::QualityMeasures::getRidgeValleyStructure(const cv::Mat &blockCropped,
 	// % Append a column of ones before dividing to include an intercept,
 	// dt1 = [intercept coefficient]
 	//  dt1 = [ones(length(x),1) x'] \ v3';
-	cv::Mat dttemp(v3.rows, 2, CV_64F);
-	for (int i = 0; i < v3.rows; i++) {
-		dttemp.at<double>(i, 0) = 1;
-		dttemp.at<double>(i, 1) = i + 1;
-	}
-
-	cv::Mat dt1;
-	try {
-		cv::solve(dttemp, v3, dt1, cv::DECOMP_QR);
-	} catch (const cv::Exception &e) {
-		throw NFIQ2::Exception(
-		    NFIQ2::ErrorCode::QualityMeasureCalculationError,
-		    "Exception during ridge/valley processing: "
-		    "cv::solve(cv::DECOMP_QR) " +
-			std::string(e.what()));
-	}
+	//
+	// With x = 1:n and column sums s, the least squares solution is
+	//   coefficient = 6 * sum((2x - n - 1) .* s) / (rows * n * (n^2 - 1))
+	//   intercept = ((n - 1) * sum(s) - 3 * sum((2x - n - 1) .* s)) /
+	//       (rows * n * (n - 1))
+	// which are ratios of exact integers.
+	int64_t sum = 0, weightedSum = 0;
+	for (int i = 0; i < n; i++) {
+		sum += colSums[i];
+		weightedSum += (2 * (i + 1) - n - 1) * colSums[i];
+	}
+	const int64_t rows = blockCropped.rows;
 
 	// Round to 10 decimal points to preserve score consistency across
-	// platforms (10^10)
-
-	dt1.forEach<double>([&](double &val, const int *) {
-		val = round(val * 10000000000) / 10000000000;
-	});
+	// platforms (10^10). Rounding the exact ratios is independent of the
+	// solver, as cv::solve(cv::DECOMP_QR) was not.
+	const double intercept = roundRatio(((n - 1) * sum) - (3 * weightedSum),
+	    rows * n * (n - 1));
+	const double coefficient = roundRatio(
+	    6 * weightedSum, rows * n * ((static_cast<int64_t>(n) * n) - 1));
 
 	//%% Block segmentation into ridge and valley regions
 	//  dt = x*dt1(2) + dt1(1);
 	double tmpx, tmpi;
-	for (int i = 0; i < v3.rows; i++) {
+	for (int i = 0; i < n; i++) {
 		tmpi = static_cast<double>(i + 1);
-		tmpx = tmpi * dt1.at<double>(1, 0) + dt1.at<double>(0, 0);
+		tmpx = tmpi * coefficient + intercept;
 		dt.push_back(tmpx);
 	}
 	// ridval = (v3 < dt)'; % ridges = 1, valleys = 0
 
 	for (unsigned int i = 0; i < dt.size(); i++) {
-		if (v3.at<double>(i, 0) < dt[i]) {
+		if (v3[i] < dt[i]) {
 			ridval.push_back(1);
 		} else {
 			ridval.push_back(0);
@@ -549,7 +835,7 @@ NFIQ2::QualityMeasures::computeNumericalGradients(const cv::Mat &mat,
 
 void
 NFIQ2::QualityMeasures::addHistogramFeatures(
-    std::unordered_map<std::string, double> &featureDataList,
+    NativeQualityMeasureVector &featureDataList, const unsigned int firstIndex,
     std::string featurePrefix, std::vector<double> &binBoundaries,
     std::vector<double> &dataVector, int binCount)
 {
@@ -581,18 +867,17 @@ NFIQ2::QualityMeasures::addHistogramFeatures(
 		bins[currentBucket]++;
 	}
 
+	/* Bins are followed by the mean and standard deviation */
 	for (int i = 0; i < binCount; i++) {
-		featureDataList[featurePrefix + std::to_string(i)] = bins[i];
+		featureDataList.set(firstIndex + i, bins[i]);
 	}
 
 	cv::Mat dataMat(dataVector);
 	cv::Scalar mean, stdDev;
 	cv::meanStdDev(dataMat, mean, stdDev);
 
-	featureDataList[featurePrefix + FeatureFunctionsMeanSuffix] =
-	    mean.val[0];
-	featureDataList[featurePrefix + FeatureFunctionsStdDevSuffix] =
-	    stdDev.val[0];
+	featureDataList.set(firstIndex + binCount, mean.val[0]);
+	featureDataList.set(firstIndex + binCount + 1, stdDev.val[0]);
 }
 
 void
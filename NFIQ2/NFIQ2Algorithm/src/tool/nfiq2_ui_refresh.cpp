@@ -19,6 +19,7 @@
 #include <be_sysdeps.h>
 #include <be_text.h>
 #include <nfiq2_algorithm.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <nfiq2_modelinfo.hpp>
 #include <nfiq2_timer.hpp>
 #include <nfir_lib.h>
@@ -354,13 +355,12 @@ NFIQ2UI::executeSingle(std::shared_ptr<BE::Image::Image> img,
 	// At this point - all images are 500PPI, have been converted to that
 	// resolution, or are assumed to be that resolution.
 
-	const NFIQ2::FingerprintImageData wrappedImage = imageProps.resampled ?
-	    NFIQ2::FingerprintImageData(postResample.data, postResample.total(),
-		postResample.cols, postResample.rows, fingerPosition,
-		requiredPPI) :
-	    NFIQ2::FingerprintImageData(grayscaleRawData,
-		grayscaleRawData.size(), imageWidth, imageHeight,
-		fingerPosition, requiredPPI);
+	const NFIQ2::FingerprintImageView wrappedImage = imageProps.resampled ?
+	    NFIQ2::FingerprintImageView(postResample.data, postResample.cols,
+		postResample.rows, static_cast<uint32_t>(postResample.step),
+		fingerPosition, requiredPPI) :
+	    NFIQ2::FingerprintImageView(grayscaleRawData, imageWidth,
+		imageHeight, imageWidth, fingerPosition, requiredPPI);
 
 	std::vector<std::shared_ptr<NFIQ2::QualityMeasures::Algorithm>>
 	    modules {};
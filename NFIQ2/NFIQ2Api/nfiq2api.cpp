@@ -1,10 +1,12 @@
 #include <nfiq2_algorithm.hpp>
 #include <nfiq2_exception.hpp>
+#include <nfiq2_fingerprintimageview.hpp>
 #include <opencv2/core/core_c.h>
 #include <opencv2/core/version.hpp>
 
 #include "nfiq2api.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
@@ -110,8 +112,16 @@ ComputeNfiq2Score(int fpos, const unsigned char *pixels, int size, int width,
 {
 	try {
 		if (g_nfiq2.get() != nullptr) {
-			NFIQ2::FingerprintImageData rawImage(pixels, size,
-			    width, height, fpos, ppi);
+			if ((width < 0) || (height < 0) ||
+			    (static_cast<int64_t>(size) <
+				static_cast<int64_t>(width) * height)) {
+				throw NFIQ2::Exception(
+				    NFIQ2::ErrorCode::BadArguments,
+				    "Image buffer is smaller than width x "
+				    "height");
+			}
+			const NFIQ2::FingerprintImageView rawImage(pixels,
+			    width, height, width, fpos, ppi);
 			int qualityScore =
 			    (int)g_nfiq2->computeUnifiedQualityScore(rawImage);
 			return qualityScore;